@@ -0,0 +1,46 @@
+// ============================================================================
+// Checkpoint.hh - Guardar y reanudar runs largos
+// ============================================================================
+// Un checkpoint (output/checkpoint_<tag>.chk, texto) contiene:
+//   - cabecera: archivo de salida, eventos pedidos/hechos, entradas del TTree
+//   - estado de tallies y scorers del Run
+//   - configuracion de /phantom/vr/ (debe coincidir al reanudar)
+//   - estado del motor de numeros aleatorios al terminar el ultimo evento
+// Al reanudar con el mismo RNG y los mismos acumuladores, los eventos que
+// faltan son exactamente los que habria simulado el run sin interrumpir.
+// ============================================================================
+
+#ifndef CHECKPOINT_HH
+#define CHECKPOINT_HH
+
+#include "globals.hh"
+
+class ImportanceSampling;
+class Run;
+
+// ===== Cabecera del checkpoint =====
+struct CheckpointInfo {
+  G4String outputTag;      // "150MeV_1000000evts_run0"
+  G4String rootFileName;   // archivo ROOT que se reabre en UPDATE
+  G4double beamEnergy = 0; // MeV
+  G4int eventsTotal = 0;   // eventos del /run/beamOn original
+  G4int eventsDone = 0;    // eventos completos guardados
+  G4long treeEntries = 0;  // entradas de raw_data en el ultimo AutoSave
+  G4bool rawSteps = true;
+};
+
+namespace Checkpoint {
+// Escribe en un archivo temporal y lo renombra: un corte a mitad de la
+// escritura deja intacto el checkpoint anterior
+// vr == nullptr equivale a splitting/ruleta desactivado
+G4bool Write(const G4String &fileName, const CheckpointInfo &info,
+             const Run &run, const ImportanceSampling *vr);
+
+// Lee la cabecera. Si run != nullptr restaura tambien tallies, scorers,
+// contador de eventos y el estado del RNG, y falla si /phantom/vr/ no
+// coincide con el del run original
+G4bool Read(const G4String &fileName, CheckpointInfo &info, Run *run,
+            const ImportanceSampling *vr = nullptr);
+} // namespace Checkpoint
+
+#endif // CHECKPOINT_HH
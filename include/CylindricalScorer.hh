@@ -0,0 +1,72 @@
+// ============================================================================
+// CylindricalScorer.hh - Dosis en (r, profundidad) alrededor del eje del haz
+// ============================================================================
+// El haz viaja sobre el eje X del phantom, asi que la dosis tiene simetria
+// azimutal. En vez de histogramar Y y Z por separado (transverse_profile.C)
+// sumamos todo el azimut en anillos: mucha mas estadistica por evento y
+// mucha menos memoria que una malla 3D.
+// Los bins radiales pueden ser de ancho variable (finos cerca del eje,
+// anchos en la cola de dosis baja).
+// ============================================================================
+
+#ifndef CYLINDRICAL_SCORER_HH
+#define CYLINDRICAL_SCORER_HH
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+class G4LogicalVolume;
+
+// ============================================================================
+class CylindricalScorer {
+public:
+  CylindricalScorer();
+  ~CylindricalScorer();
+
+  // radialEdges: bordes en unidades internas, empezando en 0 (n + 1 valores)
+  void Configure(G4int nDepthBins, const std::vector<G4double> &radialEdges,
+                 const G4LogicalVolume *volume);
+
+  // localPos: posicion en el sistema del phantom (eje del haz = X)
+  // edep ya ponderada con el peso del track
+  void Fill(const G4ThreeVector &localPos, G4double edep);
+
+  void Merge(const CylindricalScorer &other);
+
+  // Escribe en el directorio ROOT actual:
+  //   cyl_dose          TH2D dosis(profundidad, r)      Gy/primario
+  //   cyl_idd           dosis integral en profundidad   Gy cm2/primario
+  //                     (toda la rebanada del phantom, sin limite en r)
+  //   cyl_penumbra_80_20, cyl_r50                        mm
+  //                     (respecto al nucleo r < 2 mm, vacias si hay pocos
+  //                      depositos en el nucleo)
+  void WriteHistograms(G4int nEvents) const;
+
+  // Estado para los checkpoints; Load() exige el mismo binning
+  void Save(std::ostream &os) const;
+  G4bool Load(std::istream &is);
+
+private:
+  G4int RadialBin(G4double r) const;
+
+  G4int fNDepth;
+  G4int fNRadial;
+  G4bool fUniform; // bins radiales iguales -> indice directo, sin busqueda
+  G4double fHalfDepth;
+  G4double fDepthWidth;
+  G4double fDensity;
+  std::vector<G4double> fRadialEdges;
+
+  std::vector<G4double> fEdep; // indice = iDepth * fNRadial + iR
+
+  // Por rebanada de profundidad:
+  std::vector<G4double> fSliceEdep; // toda la energia, cualquier r (IDD)
+  std::vector<G4long> fCoreHits;    // depositos en el nucleo (estadistica)
+  G4int fCoreBins; // anillos del nucleo (r < 2 mm, minimo 1)
+};
+
+#endif // CYLINDRICAL_SCORER_HH
@@ -0,0 +1,78 @@
+// ============================================================================
+// DepthDoseScorer.hh - Dosis por clase de particula y LET vs profundidad
+// ============================================================================
+// Acumula durante el transporte, por bin de profundidad en el phantom:
+//   - Dosis separada en: proton primario, proton secundario, alfas/iones,
+//     electrones y otros (lo que dose_analysis.C hace con parentID)
+//   - LET promediado en dosis (LETd) y en track (LETt) de los protones
+// Con esto el analisis radiobiologico no necesita el TTree de steps.
+// ============================================================================
+
+#ifndef DEPTH_DOSE_SCORER_HH
+#define DEPTH_DOSE_SCORER_HH
+
+#include "globals.hh"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Track;
+
+// ============================================================================
+class DepthDoseScorer {
+public:
+  // Clases de particula para la descomposicion de dosis
+  enum ParticleClass {
+    kPrimaryProton = 0,
+    kSecondaryProton,
+    kIons, // alfas, deuterones, tritones, He3 y fragmentos nucleares
+    kElectrons,
+    kOther,
+    kNumClasses
+  };
+
+  DepthDoseScorer();
+  ~DepthDoseScorer();
+
+  // Define el binning a lo largo de X (direccion del haz) del volumen dado.
+  // Toma las dimensiones del G4Box y la densidad del material para la masa
+  void Configure(G4int nBins, const G4LogicalVolume *volume);
+
+  static ParticleClass Classify(const G4Track *track);
+
+  // localX: coordenada X en el sistema del phantom (centro = 0)
+  // stepLength solo se usa para el LET de los protones
+  // weight: peso del track (splitting/ruleta), pondera dosis y LET
+  void Fill(G4double localX, G4double edep, G4double stepLength,
+            G4double weight, ParticleClass particleClass);
+
+  void Merge(const DepthDoseScorer &other);
+
+  // Crea los histogramas (Gy/primario y keV/um) en el directorio ROOT actual
+  void WriteHistograms(G4int nEvents) const;
+
+  // Estado para los checkpoints; Load() exige el mismo binning
+  void Save(std::ostream &os) const;
+  G4bool Load(std::istream &is);
+
+  G4int GetNumberOfBins() const { return fNBins; }
+
+private:
+  G4int fNBins;
+  G4double fHalfDepth; // semi-longitud del phantom en X
+  G4double fBinWidth;
+  G4double fMassPerBin; // masa de una rebanada (unidades internas)
+
+  std::vector<G4double> fEdep[kNumClasses]; // energia depositada por clase
+
+  // LET de protones (w = peso del track):
+  //   LETd = sum(w edep L) / sum(w edep)   con L = edep / l por step
+  //   LETt = sum(w l L) / sum(w l) = sum(w edep) / sum(w l)
+  std::vector<G4double> fEdepLET;     // sum(w edep L)
+  std::vector<G4double> fEdepProton;  // sum(w edep)
+  std::vector<G4double> fTrackLength; // sum(w l)
+};
+
+#endif // DEPTH_DOSE_SCORER_HH
@@ -0,0 +1,28 @@
+// ============================================================================
+// EventAction.hh - Acciones al final de cada evento
+// ============================================================================
+// Solo avisa a RunAction que termino un evento, para que escriba un
+// checkpoint cada N eventos (/phantom/checkpoint/every)
+// ============================================================================
+
+#ifndef EVENT_ACTION_HH
+#define EVENT_ACTION_HH
+
+#include "G4UserEventAction.hh"
+
+// forward declaration
+class RunAction;
+
+// ============================================================================
+class EventAction : public G4UserEventAction {
+public:
+  EventAction(RunAction *runAction);
+  virtual ~EventAction();
+
+  virtual void EndOfEventAction(const G4Event *event);
+
+private:
+  RunAction *fRunAction;
+};
+
+#endif // EVENT_ACTION_HH
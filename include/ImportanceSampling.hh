@@ -0,0 +1,81 @@
+// ============================================================================
+// ImportanceSampling.hh - Splitting y ruleta rusa por celdas de importancia
+// ============================================================================
+// La dosis fuera del campo (neutrones y gammas secundarios que salen del
+// phantom) es muy baja: con transporte analogo casi ninguna historia llega
+// lejos. Dividimos el espacio en celdas (planos en X, cilindros alrededor
+// del eje del haz o esferas) con una importancia I cada una. Cuando una
+// particula sesgada pasa de la celda a a la b, con R = I_b / I_a:
+//   R > 1  se divide en ~R copias con peso w / R (splitting)
+//   R < 1  sobrevive con probabilidad R y peso w / R (ruleta rusa)
+// El peso esperado se conserva, asi que todo lo que se acumula con el peso
+// del track (tallies, scorers, raw_data) sigue siendo insesgado.
+// Las fronteras no son volumenes de Geant4: se revisan en cada step, y un
+// step largo puede cruzar varias celdas de una vez (sigue siendo insesgado,
+// solo un poco menos eficiente).
+// ============================================================================
+
+#ifndef IMPORTANCE_SAMPLING_HH
+#define IMPORTANCE_SAMPLING_HH
+
+#include "G4ThreeVector.hh"
+#include "G4TrackVector.hh"
+#include "globals.hh"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Step;
+class ImportanceSamplingMessenger;
+
+// ============================================================================
+class ImportanceSampling {
+public:
+  // Forma de las celdas (coordenadas globales, eje del haz = X)
+  enum CellGeometry { kNone = 0, kPlanes, kCylinders, kSpheres };
+
+  ImportanceSampling();
+  ~ImportanceSampling();
+
+  // Aplica splitting/ruleta al final del step. Las copias se agregan a
+  // secondaries (el fSecondary del G4SteppingManager)
+  void Apply(const G4Step *step, G4TrackVector *secondaries);
+
+  // ===== Configuracion desde macro (/phantom/vr/) =====
+  void SetGeometry(CellGeometry geometry);
+  void SetBoundaries(const std::vector<G4double> &boundaries);
+  void SetImportances(const std::vector<G4double> &importances);
+  void SetCentre(const G4ThreeVector &centre) { fCentre = centre; }
+  void SetParticles(const std::vector<G4String> &names);
+
+  G4bool IsActive() const { return fActive; }
+
+  // Configuracion para los checkpoints: al reanudar, Matches() exige las
+  // mismas celdas, importancias y particulas que el run original
+  void Save(std::ostream &os) const;
+  G4bool Matches(std::istream &is) const;
+
+private:
+  // Recalcula fActive y avisa si la configuracion no es consistente
+  void Update();
+  G4int CellIndex(const G4ThreeVector &position) const;
+  G4bool IsBiased(const G4ParticleDefinition *particle);
+
+  ImportanceSamplingMessenger *fMessenger;
+
+  G4bool fActive;
+  CellGeometry fGeometry;
+  G4ThreeVector fCentre;             // centro de las esferas
+  std::vector<G4double> fBoundaries; // n fronteras crecientes -> n + 1 celdas
+  std::vector<G4double> fImportances;
+
+  // Particulas sesgadas: nombres del macro, punteros resueltos al usarse
+  std::vector<G4String> fParticleNames;
+  std::vector<const G4ParticleDefinition *> fParticles;
+  G4bool fParticlesResolved;
+  G4bool fAllParticles; // "all" en la lista
+};
+
+#endif // IMPORTANCE_SAMPLING_HH
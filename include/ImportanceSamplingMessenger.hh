@@ -0,0 +1,42 @@
+// ============================================================================
+// ImportanceSamplingMessenger.hh - Comandos /phantom/vr/ (splitting y ruleta)
+// ============================================================================
+// Comandos disponibles:
+//   /phantom/vr/geometry <none|planes|cylinders|spheres>
+//   /phantom/vr/boundaries <b1 ... bn>    fronteras crecientes en cm
+//   /phantom/vr/importances <I0 ... In>   una importancia por celda
+//   /phantom/vr/centre <x y z> <unidad>   centro de las esferas
+//   /phantom/vr/particles <p1 p2 ...>     particulas sesgadas ("all" = todas)
+// ============================================================================
+
+#ifndef IMPORTANCE_SAMPLING_MESSENGER_HH
+#define IMPORTANCE_SAMPLING_MESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class ImportanceSampling;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWith3VectorAndUnit;
+
+// ============================================================================
+class ImportanceSamplingMessenger : public G4UImessenger {
+public:
+  ImportanceSamplingMessenger(ImportanceSampling *sampling);
+  virtual ~ImportanceSamplingMessenger();
+
+  virtual void SetNewValue(G4UIcommand *command, G4String newValue);
+
+private:
+  ImportanceSampling *fSampling;
+
+  G4UIdirectory *fVRDir;
+
+  G4UIcmdWithAString *fGeometryCmd;
+  G4UIcmdWithAString *fBoundariesCmd;
+  G4UIcmdWithAString *fImportancesCmd;
+  G4UIcmdWith3VectorAndUnit *fCentreCmd;
+  G4UIcmdWithAString *fParticlesCmd;
+};
+
+#endif // IMPORTANCE_SAMPLING_MESSENGER_HH
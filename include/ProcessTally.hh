@@ -0,0 +1,96 @@
+// ============================================================================
+// ProcessTally.hh - Contadores por proceso, particula y volumen
+// ============================================================================
+// Reemplaza el conteo offline de process_analysis.C: en vez de leer cada
+// step del TTree y sumar en std::map<std::string,...>, contamos durante la
+// simulacion con claves de puntero (G4VProcess*, G4ParticleDefinition*,
+// G4VPhysicalVolume*) sobre un arreglo plano.
+// Cada hilo tiene su propio ProcessTally (dentro de su Run) y se combinan
+// por nombre en Run::Merge() al final del run.
+// ============================================================================
+
+#ifndef PROCESS_TALLY_HH
+#define PROCESS_TALLY_HH
+
+#include "globals.hh"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+class G4VProcess;
+class G4ParticleDefinition;
+class G4VPhysicalVolume;
+
+// ============================================================================
+class ProcessTally {
+public:
+  ProcessTally();
+  ~ProcessTally();
+
+  // Registra un step: proceso que lo limito, particula y volumen pre-step.
+  // edep y secundarios se ponderan con el peso del track (splitting/ruleta);
+  // steps es la cuenta de la simulacion, sin ponderar
+  void Fill(const G4VProcess *process, const G4ParticleDefinition *particle,
+            const G4VPhysicalVolume *volume, G4double edep,
+            G4int nSecondaries, G4double weight = 1.0);
+
+  // Suma otro tally (de otro hilo) emparejando claves por nombre
+  void Merge(const ProcessTally &other);
+
+  void Reset();
+
+  // Tablas de resumen: por proceso, por particula, por volumen y desglose
+  void WriteSummary(std::ostream &os) const;
+
+  // Estado completo para los checkpoints (texto, precision completa).
+  // Las filas cargadas no tienen punteros: Fill() se los asocia por nombre
+  void Save(std::ostream &os) const;
+  G4bool Load(std::istream &is);
+
+  // ===== Contenido de cada celda =====
+  struct Cell {
+    G4long steps = 0;         // sin ponderar
+    G4double edep = 0;        // MeV, sum(w edep)
+    G4double secondaries = 0; // secundarios creados, sum(w n)
+  };
+
+private:
+  // ===== Registro puntero -> indice de nombre =====
+  // Una fila por nombre: QGSP_BIC crea una instancia de msc, hIoni,
+  // hadElastic... por particula, y todas comparten la fila de su nombre.
+  // Pocas entradas: una busqueda lineal con cache del ultimo acierto es mas
+  // rapida que un hash
+  struct Registry {
+    std::vector<G4String> names;    // filas de la tabla
+    std::vector<const void *> keys; // punteros ya vistos
+    std::vector<G4int> keyIndex;    // fila (indice en names) de cada puntero
+    const void *lastKey = nullptr;
+    G4int lastIndex = -1;
+
+    G4int Find(const void *key);
+    G4int FindByName(const G4String &name) const;
+    // Fila nueva sin punteros (Merge() y Load())
+    G4int Add(const G4String &name);
+    // Asocia un puntero nuevo a la fila de su nombre (creandola si falta)
+    G4int Bind(const void *key, const G4String &name);
+    G4int Size() const { return G4int(names.size()); }
+  };
+
+  G4int CellIndex(G4int iProc, G4int iPart, G4int iVol) const {
+    return (iVol * fCapParticles + iPart) * fCapProcesses + iProc;
+  }
+  // Agranda el arreglo plano (duplicando) si algun registro no cabe
+  void Reserve(G4int nProc, G4int nPart, G4int nVol);
+
+  Registry fProcesses;
+  Registry fParticles;
+  Registry fVolumes;
+
+  G4int fCapProcesses;
+  G4int fCapParticles;
+  G4int fCapVolumes;
+  std::vector<Cell> fCells;
+};
+
+#endif // PROCESS_TALLY_HH
@@ -0,0 +1,57 @@
+// ============================================================================
+// Run.hh - Run propio con los contadores acumulados durante el transporte
+// ============================================================================
+// G4Run solo guarda el numero de eventos; aqui agregamos nuestros tallies.
+// En modo multihilo cada worker tiene su Run y Geant4 llama a Merge() para
+// sumarlos en el Run del master al final.
+// ============================================================================
+
+#ifndef RUN_HH
+#define RUN_HH
+
+#include "G4Run.hh"
+
+#include "CylindricalScorer.hh"
+#include "DepthDoseScorer.hh"
+#include "ProcessTally.hh"
+
+#include <istream>
+#include <ostream>
+
+// ============================================================================
+class Run : public G4Run {
+public:
+  Run();
+  virtual ~Run();
+
+  // Suma el Run de un worker en el del master
+  virtual void Merge(const G4Run *run);
+
+  // Estado de tallies y scorers para los checkpoints
+  void Save(std::ostream &os) const;
+  G4bool Load(std::istream &is);
+
+  // Al reanudar, el Run arranca con los eventos ya hechos antes del corte
+  void SetNumberOfEvent(G4int n) { numberOfEvent = n; }
+
+  ProcessTally &GetProcessTally() { return fProcessTally; }
+  const ProcessTally &GetProcessTally() const { return fProcessTally; }
+
+  DepthDoseScorer &GetDepthDoseScorer() { return fDepthDose; }
+  const DepthDoseScorer &GetDepthDoseScorer() const { return fDepthDose; }
+
+  CylindricalScorer &GetCylindricalScorer() { return fCylindrical; }
+  const CylindricalScorer &GetCylindricalScorer() const {
+    return fCylindrical;
+  }
+
+private:
+  // steps, energia y secundarios por proceso / particula / volumen
+  ProcessTally fProcessTally;
+  // dosis por clase de particula y LET vs profundidad en el phantom
+  DepthDoseScorer fDepthDose;
+  // dosis en (r, profundidad) alrededor del eje del haz
+  CylindricalScorer fCylindrical;
+};
+
+#endif // RUN_HH
@@ -3,6 +3,11 @@
 // ============================================================================
 // El nombre del archivo se genera automaticamente con:
 //   energia_numeroEventos_runID.root
+// Junto a cada archivo ROOT se escribe tally_<...>.txt con los contadores
+// por proceso/particula/volumen acumulados en Run
+// Con /phantom/checkpoint/every N se guarda un checkpoint cada N eventos y
+// /phantom/checkpoint/resume <archivo> continua el run interrumpido
+// (solo modo secuencial, G4RunManager)
 // ============================================================================
 
 #ifndef RUN_ACTION_HH
@@ -11,14 +16,20 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 
+#include "Checkpoint.hh"
+
 // Headers de ROOT
 #include "TFile.h"
 #include "TTree.h"
 
 #include <string>
+#include <vector>
 
 // Forward declaration
 class G4ParticleGun;
+class ImportanceSampling;
+class Run;
+class RunActionMessenger;
 
 // ============================================================================
 class RunAction : public G4UserRunAction {
@@ -26,18 +37,74 @@ public:
   RunAction();
   virtual ~RunAction();
 
+  // Crea nuestro Run (con los tallies) en vez del G4Run por defecto
+  virtual G4Run *GenerateRun();
+
   virtual void BeginOfRunAction(const G4Run *run);
   virtual void EndOfRunAction(const G4Run *run);
 
+  // Llamado por EventAction al terminar cada evento
+  void EndOfEvent();
+
   // Metodo para llenar el TTree con datos RAW
   void FillRawData(G4int eventID, G4int trackID, G4int parentID,
                    const G4String &particleName, G4int pdgCode, G4double x_pre,
                    G4double y_pre, G4double z_pre, G4double x_post,
                    G4double y_post, G4double z_post, G4double edep,
                    G4double kinE_pre, G4double kinE_post, G4double stepLength,
-                   const G4String &processName, const G4String &volumeName);
+                   G4double weight, const G4String &processName,
+                   const G4String &volumeName);
+
+  // ===== Configuracion desde macro (RunActionMessenger) =====
+  void SetWriteRawSteps(G4bool enable) { fWriteRawSteps = enable; }
+  G4bool GetWriteRawSteps() const { return fWriteRawSteps; }
+  void SetDepthBins(G4int nBins) { fDepthBins = nBins; }
+  void SetCylDepthBins(G4int nBins) { fCylDepthBins = nBins; }
+  void SetCylRadialBins(G4int nBins) { fCylRadialBins = nBins; }
+  void SetCylRMax(G4double rMax) { fCylRMax = rMax; }
+  void SetCylRadialEdges(const std::vector<G4double> &edges) {
+    fCylRadialEdges = edges;
+  }
+  void SetCheckpointEvery(G4int nEvents) { fCheckpointEvery = nEvents; }
+  // SteppingAction registra su splitting/ruleta para guardarlo en los
+  // checkpoints
+  void SetImportanceSampling(const ImportanceSampling *vr) {
+    fImportanceSampling = vr;
+  }
+
+  // Restaura el checkpoint y lanza BeamOn() con los eventos que faltan
+  void ResumeFromCheckpoint(const G4String &fileName);
 
 private:
+  // Crea las ramas de raw_data (create = true) o las reconecta al reanudar
+  void ConnectRawBranches(G4bool create);
+  void WriteCheckpoint(G4int eventsDone);
+
+  RunActionMessenger *fMessenger;
+  Run *fCurrentRun;
+
+  // true = TTree raw_data con cada step (puede ser de varios GB)
+  G4bool fWriteRawSteps;
+  // bins de profundidad del DepthDoseScorer (0 = desactivado)
+  G4int fDepthBins;
+
+  // CylindricalScorer: bordes variables si fCylRadialEdges no esta vacio,
+  // si no fCylRadialBins anillos iguales hasta fCylRMax
+  G4int fCylDepthBins;
+  G4int fCylRadialBins;
+  G4double fCylRMax;
+  std::vector<G4double> fCylRadialEdges;
+
+  // ===== Checkpoints =====
+  G4int fCheckpointEvery; // 0 = desactivado
+  G4int fEventsTotal;     // eventos del run completo (no solo de este BeamOn)
+  G4int fEventOffset;     // eventos previos al reanudar (para eventID)
+  G4bool fResuming;
+  G4String fResumeFile;
+  CheckpointInfo fResumeInfo;
+  const ImportanceSampling *fImportanceSampling;
+  std::string fCheckpointName;
+
   TFile *fRootFile;
   TTree *fTree;
 
@@ -52,11 +119,15 @@ private:
   G4double fEdep;
   G4double fKinE_pre, fKinE_post;
   G4double fStepLength;
+  G4double fWeight; // peso del track (1 sin splitting/ruleta)
   char fProcessName[32];
   char fVolumeName[32];
 
   // Variable para guardar la energia del beam (para el nombre del archivo)
   G4double fBeamEnergy;
+
+  // Etiqueta comun de los archivos del run: "150MeV_10000evts_run0"
+  std::string fOutputTag;
 };
 
 #endif
@@ -0,0 +1,56 @@
+// ============================================================================
+// RunActionMessenger.hh - Comandos /phantom/ para configurar la salida
+// ============================================================================
+// Comandos disponibles (antes de /run/beamOn):
+//   /phantom/output/rawSteps <bool>   guarda (o no) el TTree de steps
+//   /phantom/score/depthBins <n>      bins de profundidad del scorer LET
+//   /phantom/score/cyl/depthBins <n>  bins de profundidad del scorer (r, x)
+//   /phantom/score/cyl/radialBins <n> anillos de igual ancho hasta rMax
+//   /phantom/score/cyl/rMax <r> <unidad>
+//   /phantom/score/cyl/radialEdges <r0 r1 ... rn>  bordes variables en cm
+//   /phantom/checkpoint/every <n>     checkpoint cada n eventos (0 = no)
+//   /phantom/checkpoint/resume <archivo.chk>  continua un run interrumpido
+// ============================================================================
+
+#ifndef RUN_ACTION_MESSENGER_HH
+#define RUN_ACTION_MESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class RunAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+
+// ============================================================================
+class RunActionMessenger : public G4UImessenger {
+public:
+  RunActionMessenger(RunAction *runAction);
+  virtual ~RunActionMessenger();
+
+  virtual void SetNewValue(G4UIcommand *command, G4String newValue);
+
+private:
+  RunAction *fRunAction;
+
+  G4UIdirectory *fPhantomDir;
+  G4UIdirectory *fOutputDir;
+  G4UIdirectory *fScoreDir;
+  G4UIdirectory *fCylDir;
+  G4UIdirectory *fCheckpointDir;
+
+  G4UIcmdWithABool *fRawStepsCmd;
+  G4UIcmdWithAnInteger *fDepthBinsCmd;
+
+  G4UIcmdWithAnInteger *fCylDepthBinsCmd;
+  G4UIcmdWithAnInteger *fCylRadialBinsCmd;
+  G4UIcmdWithADoubleAndUnit *fCylRMaxCmd;
+  G4UIcmdWithAString *fCylRadialEdgesCmd;
+
+  G4UIcmdWithAnInteger *fCheckpointEveryCmd;
+  G4UIcmdWithAString *fResumeCmd;
+};
+
+#endif // RUN_ACTION_MESSENGER_HH
@@ -7,9 +7,11 @@
 #define STEPPING_ACTION_HH
 
 #include "G4UserSteppingAction.hh" // clase base
+#include "ImportanceSampling.hh"    // splitting y ruleta rusa (/phantom/vr/)
 
 // forward declaration
 class RunAction;
+class G4LogicalVolume;
 
 // ============================================================================
 // CLASE SteppingAction
@@ -29,6 +31,12 @@ public:
 private:
   // puntero a RunAction para poder llenar los histogramas
   RunAction *fRunAction;
+
+  // volumen logico del phantom (donde acumulan los scorers)
+  G4LogicalVolume *fScoringVolume;
+
+  // reduccion de varianza por celdas de importancia
+  ImportanceSampling fImportance;
 };
 
 #endif // STEPPING_ACTION_HH
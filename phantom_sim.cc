@@ -22,6 +22,7 @@
 
 // ===== SECCION 3: Nuestras clases (las que vamos a crear nosotros) =====
 #include "DetectorConstruction.hh"   // geometria: el phantom y el mundo
+#include "EventAction.hh"            // checkpoints al final de cada evento
 #include "PrimaryGeneratorAction.hh" // fuente: el haz de protones
 #include "RunAction.hh"              // acciones al inicio/fin del run
 #include "SteppingAction.hh"         // registra cada paso de particula
@@ -74,6 +75,9 @@ int main(int argc, char **argv) {
   // Aqui registramos la deposicion de energia para la dosis
   runManager->SetUserAction(new SteppingAction(runAction));
 
+  // EventAction - al final de cada evento (checkpoints periodicos)
+  runManager->SetUserAction(new EventAction(runAction));
+
   // ===== SECCION 8: Inicializar Geant4 =====
   // Esto construye la geometria y prepara todo
   runManager->Initialize();
@@ -0,0 +1,121 @@
+// ============================================================================
+// Checkpoint.cc - Escritura/lectura de checkpoints
+// ============================================================================
+
+#include "Checkpoint.hh"
+#include "ImportanceSampling.hh"
+#include "Run.hh"
+
+#include "Randomize.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+// ===== Formato =====
+// phantom_checkpoint <version>
+// <clave> <valor>   (una por linea, hasta "run")
+// run      -> Run::Save()
+// vr       -> ImportanceSampling::Save() ("0" si no hay splitting/ruleta)
+// engine   -> HepRandomEngine::put()
+static const G4int kCheckpointVersion = 3;
+
+// ============================================================================
+// Write()
+// ============================================================================
+G4bool Checkpoint::Write(const G4String &fileName, const CheckpointInfo &info,
+                         const Run &run, const ImportanceSampling *vr) {
+  G4String tmpName = fileName + ".tmp";
+  {
+    std::ofstream os(tmpName);
+    if (!os)
+      return false;
+
+    os << "phantom_checkpoint " << kCheckpointVersion << "\n";
+    os << "outputTag " << info.outputTag << "\n";
+    os << "rootFile " << info.rootFileName << "\n";
+    os << "beamEnergy " << std::setprecision(17) << info.beamEnergy << "\n";
+    os << "eventsTotal " << info.eventsTotal << "\n";
+    os << "eventsDone " << info.eventsDone << "\n";
+    os << "treeEntries " << info.treeEntries << "\n";
+    os << "rawSteps " << (info.rawSteps ? 1 : 0) << "\n";
+
+    os << "run\n";
+    run.Save(os);
+
+    os << "\nvr\n";
+    if (vr)
+      vr->Save(os);
+    else
+      os << "0\n";
+
+    os << "\nengine\n";
+    G4Random::getTheEngine()->put(os);
+
+    os.flush();
+    if (!os)
+      return false;
+  }
+  // rename() reemplaza el checkpoint viejo de forma atomica
+  return std::rename(tmpName.c_str(), fileName.c_str()) == 0;
+}
+
+// ============================================================================
+// Read()
+// ============================================================================
+G4bool Checkpoint::Read(const G4String &fileName, CheckpointInfo &info,
+                        Run *run, const ImportanceSampling *vr) {
+  std::ifstream is(fileName);
+  std::string key;
+  G4int version = 0;
+  if (!is || !(is >> key >> version) || key != "phantom_checkpoint" ||
+      version != kCheckpointVersion)
+    return false;
+
+  // ===== Cabecera =====
+  while (is >> key && key != "run") {
+    if (key == "outputTag")
+      is >> info.outputTag;
+    else if (key == "rootFile")
+      is >> info.rootFileName;
+    else if (key == "beamEnergy")
+      is >> info.beamEnergy;
+    else if (key == "eventsTotal")
+      is >> info.eventsTotal;
+    else if (key == "eventsDone")
+      is >> info.eventsDone;
+    else if (key == "treeEntries")
+      is >> info.treeEntries;
+    else if (key == "rawSteps")
+      is >> info.rawSteps;
+    else
+      return false;
+  }
+  if (key != "run" || !is)
+    return false;
+  if (!run)
+    return true;
+
+  // ===== Tallies, scorers y contador de eventos =====
+  if (!run->Load(is))
+    return false;
+  run->SetNumberOfEvent(info.eventsDone);
+
+  // ===== Misma reduccion de varianza que el run original =====
+  if (!(is >> key) || key != "vr")
+    return false;
+  if (vr) {
+    if (!vr->Matches(is))
+      return false;
+  } else {
+    G4int active = -1;
+    if (!(is >> active) || active != 0)
+      return false;
+  }
+
+  // ===== Motor de numeros aleatorios =====
+  if (!(is >> key) || key != "engine")
+    return false;
+  G4Random::getTheEngine()->get(is);
+  return !is.fail();
+}
@@ -0,0 +1,256 @@
+// ============================================================================
+// CylindricalScorer.cc - Dosis en (r, profundidad) con simetria azimutal
+// ============================================================================
+
+#include "CylindricalScorer.hh"
+
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+// Headers de ROOT
+#include "TH1D.h"
+#include "TH2D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// ===== Constructor =====
+CylindricalScorer::CylindricalScorer()
+    : fNDepth(0), fNRadial(0), fUniform(true), fHalfDepth(0), fDepthWidth(0),
+      fDensity(0), fCoreBins(1) {}
+
+// Nucleo del perfil lateral: normaliza penumbra y r50 (un solo anillo
+// central tiene muy poca masa y mucho ruido)
+static const G4double kCoreRadius = 2.0 * mm;
+// Depositos minimos en el nucleo para calcular penumbra y r50
+static const G4long kMinCoreHits = 100;
+
+// ===== Destructor =====
+CylindricalScorer::~CylindricalScorer() {}
+
+// ============================================================================
+// Configure() - Profundidad a lo largo de X, anillos en el plano Y-Z
+// ============================================================================
+void CylindricalScorer::Configure(G4int nDepthBins,
+                                  const std::vector<G4double> &radialEdges,
+                                  const G4LogicalVolume *volume) {
+  const G4Box *box = dynamic_cast<const G4Box *>(volume->GetSolid());
+  if (!box || nDepthBins <= 0 || radialEdges.size() < 2) {
+    fNDepth = 0;
+    return;
+  }
+
+  fNDepth = nDepthBins;
+  fNRadial = G4int(radialEdges.size()) - 1;
+  fRadialEdges = radialEdges;
+  fHalfDepth = box->GetXHalfLength();
+  fDepthWidth = 2.0 * fHalfDepth / nDepthBins;
+  fDensity = volume->GetMaterial()->GetDensity();
+
+  // Anillos que se salen del phantom tendrian la masa mal calculada
+  G4double rInside = std::min(box->GetYHalfLength(), box->GetZHalfLength());
+  if (fRadialEdges.back() > rInside * (1.0 + 1e-9)) {
+    G4Exception("CylindricalScorer::Configure", "Scoring002", JustWarning,
+                "El radio maximo excede el phantom: los anillos exteriores "
+                "no estan completos y su dosis queda subestimada");
+  }
+
+  // Bins uniformes -> indice directo en Fill()
+  G4double width = fRadialEdges[1] - fRadialEdges[0];
+  fUniform = true;
+  for (G4int i = 1; i <= fNRadial && fUniform; i++) {
+    G4double w = fRadialEdges[i] - fRadialEdges[i - 1];
+    fUniform = std::fabs(w - width) < 1e-9 * width;
+  }
+
+  fCoreBins = 1;
+  while (fCoreBins < fNRadial && fRadialEdges[fCoreBins + 1] <= kCoreRadius)
+    fCoreBins++;
+
+  fEdep.assign(std::size_t(fNDepth) * fNRadial, 0.0);
+  fSliceEdep.assign(fNDepth, 0.0);
+  fCoreHits.assign(fNDepth, 0);
+}
+
+// ============================================================================
+// RadialBin() - Indice del anillo, -1 si cae fuera
+// ============================================================================
+G4int CylindricalScorer::RadialBin(G4double r) const {
+  if (r < fRadialEdges.front() || r >= fRadialEdges.back())
+    return -1;
+  if (fUniform) {
+    G4int bin = G4int((r - fRadialEdges.front()) /
+                      (fRadialEdges[1] - fRadialEdges[0]));
+    return std::min(bin, fNRadial - 1);
+  }
+  return G4int(std::upper_bound(fRadialEdges.begin(), fRadialEdges.end(), r) -
+               fRadialEdges.begin()) -
+         1;
+}
+
+// ============================================================================
+// Fill()
+// ============================================================================
+void CylindricalScorer::Fill(const G4ThreeVector &localPos, G4double edep) {
+  if (fNDepth == 0 || edep <= 0)
+    return;
+
+  G4int iDepth = G4int((localPos.x() + fHalfDepth) / fDepthWidth);
+  if (iDepth < 0 || iDepth >= fNDepth)
+    return;
+
+  // La IDD cuenta todo, incluso fuera del ultimo anillo (esquinas del box)
+  fSliceEdep[iDepth] += edep;
+
+  G4int iR = RadialBin(std::hypot(localPos.y(), localPos.z()));
+  if (iR < 0)
+    return;
+
+  fEdep[std::size_t(iDepth) * fNRadial + iR] += edep;
+  if (iR < fCoreBins)
+    fCoreHits[iDepth]++;
+}
+
+// ============================================================================
+// Merge()
+// ============================================================================
+void CylindricalScorer::Merge(const CylindricalScorer &other) {
+  if (other.fEdep.size() != fEdep.size())
+    return;
+  for (std::size_t i = 0; i < fEdep.size(); i++)
+    fEdep[i] += other.fEdep[i];
+  for (G4int iz = 0; iz < fNDepth; iz++) {
+    fSliceEdep[iz] += other.fSliceEdep[iz];
+    fCoreHits[iz] += other.fCoreHits[iz];
+  }
+}
+
+// ============================================================================
+// Save() / Load() - Binning (para validar) y energia por bin
+// ============================================================================
+void CylindricalScorer::Save(std::ostream &os) const {
+  os << fNDepth << " " << fNRadial << "\n" << std::setprecision(17);
+  for (G4double r : fRadialEdges)
+    os << r << " ";
+  os << "\n";
+  for (G4double x : fEdep)
+    os << x << " ";
+  os << "\n";
+  for (G4double x : fSliceEdep)
+    os << x << " ";
+  os << "\n";
+  for (G4long n : fCoreHits)
+    os << n << " ";
+  os << "\n";
+}
+
+G4bool CylindricalScorer::Load(std::istream &is) {
+  G4int nDepth = -1, nRadial = -1;
+  if (!(is >> nDepth >> nRadial) || nDepth != fNDepth)
+    return false;
+  if (fNDepth == 0)
+    return true; // desactivado en ambos
+  if (nRadial != fNRadial)
+    return false;
+  for (G4double r : fRadialEdges) {
+    G4double saved;
+    if (!(is >> saved) || std::fabs(saved - r) > 1e-9 * (1.0 + std::fabs(r)))
+      return false;
+  }
+  for (G4double &x : fEdep)
+    if (!(is >> x))
+      return false;
+  for (G4double &x : fSliceEdep)
+    if (!(is >> x))
+      return false;
+  for (G4long &n : fCoreHits)
+    if (!(is >> n))
+      return false;
+  return true;
+}
+
+// ===== Radio donde el perfil cae a fraction * dCore (interpolado) =====
+// Se busca desde afuera el ultimo anillo que sigue sobre el nivel: un anillo
+// ruidoso dentro del campo no adelanta el cruce
+static G4double CrossingRadius(const std::vector<G4double> &dose,
+                               const std::vector<G4double> &centers,
+                               G4double dCore, G4double fraction) {
+  G4double level = fraction * dCore;
+  if (level <= 0)
+    return 0;
+  for (std::size_t i = dose.size() - 1; i > 0; i--) {
+    if (dose[i - 1] >= level && dose[i] < level) {
+      G4double t = (dose[i - 1] - level) / (dose[i - 1] - dose[i]);
+      return centers[i - 1] + t * (centers[i] - centers[i - 1]);
+    }
+    if (dose[i] >= level)
+      return 0; // el perfil no cae hasta ese nivel dentro del rango
+  }
+  return 0;
+}
+
+// ============================================================================
+// WriteHistograms()
+// ============================================================================
+void CylindricalScorer::WriteHistograms(G4int nEvents) const {
+  if (fNDepth == 0 || nEvents <= 0)
+    return;
+
+  const G4double depth = 2.0 * fHalfDepth / cm;
+  std::vector<G4double> edgesCm(fNRadial + 1);
+  std::vector<G4double> centers(fNRadial);
+  for (G4int i = 0; i <= fNRadial; i++)
+    edgesCm[i] = fRadialEdges[i] / cm;
+  for (G4int i = 0; i < fNRadial; i++)
+    centers[i] = 0.5 * (fRadialEdges[i] + fRadialEdges[i + 1]);
+
+  // Los histogramas quedan en el directorio actual (el TFile del run)
+  TH2D *hDose =
+      new TH2D("cyl_dose", "Dosis cilindrica;Profundidad (cm);r (cm)", fNDepth,
+               0, depth, fNRadial, edgesCm.data());
+  TH1D *hIDD = new TH1D(
+      "cyl_idd", "Dosis integral;Profundidad (cm);IDD (Gy cm^{2}/primario)",
+      fNDepth, 0, depth);
+  TH1D *hPenumbra = new TH1D(
+      "cyl_penumbra_80_20",
+      "Penumbra lateral 80%-20%;Profundidad (cm);Penumbra (mm)", fNDepth, 0,
+      depth);
+  TH1D *hR50 = new TH1D("cyl_r50", "Radio al 50%;Profundidad (cm);r_{50} (mm)",
+                        fNDepth, 0, depth);
+
+  std::vector<G4double> profile(fNRadial);
+  for (G4int iz = 0; iz < fNDepth; iz++) {
+    G4double edepCore = 0, massCore = 0;
+    for (G4int ir = 0; ir < fNRadial; ir++) {
+      G4double edep = fEdep[std::size_t(iz) * fNRadial + ir];
+      G4double r1 = fRadialEdges[ir], r2 = fRadialEdges[ir + 1];
+      G4double mass = pi * (r2 * r2 - r1 * r1) * fDepthWidth * fDensity;
+      profile[ir] = edep / (mass * nEvents);
+      hDose->SetBinContent(iz + 1, ir + 1, profile[ir] / gray);
+      if (ir < fCoreBins) {
+        edepCore += edep;
+        massCore += mass;
+      }
+    }
+
+    // IDD = energia de toda la rebanada (cualquier r) / (rho * dz)
+    G4double idd = fSliceEdep[iz] / (fDensity * fDepthWidth * nEvents);
+    hIDD->SetBinContent(iz + 1, idd / (gray * cm2));
+
+    // Penumbra y r50 respecto a la dosis media del nucleo; sin estadistica
+    // en el nucleo (mas alla del pico) el bin queda vacio
+    if (fCoreHits[iz] < kMinCoreHits)
+      continue;
+    G4double dCore = edepCore / (massCore * nEvents);
+    G4double r80 = CrossingRadius(profile, centers, dCore, 0.8);
+    G4double r20 = CrossingRadius(profile, centers, dCore, 0.2);
+    if (r80 > 0 && r20 > 0)
+      hPenumbra->SetBinContent(iz + 1, (r20 - r80) / mm);
+    hR50->SetBinContent(iz + 1,
+                        CrossingRadius(profile, centers, dCore, 0.5) / mm);
+  }
+}
@@ -0,0 +1,187 @@
+// ============================================================================
+// DepthDoseScorer.cc - Dosis por clase de particula y LET vs profundidad
+// ============================================================================
+
+#include "DepthDoseScorer.hh"
+
+#include "G4Box.hh"
+#include "G4Electron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Proton.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+// Headers de ROOT
+#include "TH1D.h"
+
+#include <iomanip>
+
+// ===== Constructor =====
+DepthDoseScorer::DepthDoseScorer()
+    : fNBins(0), fHalfDepth(0), fBinWidth(0), fMassPerBin(0) {}
+
+// ===== Destructor =====
+DepthDoseScorer::~DepthDoseScorer() {}
+
+// ============================================================================
+// Configure() - Binning en X y masa de cada rebanada
+// ============================================================================
+void DepthDoseScorer::Configure(G4int nBins, const G4LogicalVolume *volume) {
+  const G4Box *box = dynamic_cast<const G4Box *>(volume->GetSolid());
+  if (!box || nBins <= 0) {
+    G4Exception("DepthDoseScorer::Configure", "Scoring001", JustWarning,
+                "El volumen de scoring no es un G4Box, scorer desactivado");
+    fNBins = 0;
+    return;
+  }
+
+  fNBins = nBins;
+  fHalfDepth = box->GetXHalfLength();
+  fBinWidth = 2.0 * fHalfDepth / nBins;
+
+  // Rebanada completa en Y-Z (igual que dose_analysis.C)
+  G4double area = 4.0 * box->GetYHalfLength() * box->GetZHalfLength();
+  fMassPerBin = fBinWidth * area * volume->GetMaterial()->GetDensity();
+
+  for (auto &edep : fEdep)
+    edep.assign(nBins, 0.0);
+  fEdepLET.assign(nBins, 0.0);
+  fEdepProton.assign(nBins, 0.0);
+  fTrackLength.assign(nBins, 0.0);
+}
+
+// ============================================================================
+// Classify() - Clase de la particula para la descomposicion de dosis
+// ============================================================================
+DepthDoseScorer::ParticleClass
+DepthDoseScorer::Classify(const G4Track *track) {
+  const G4ParticleDefinition *particle = track->GetDefinition();
+  if (particle == G4Proton::Definition())
+    return track->GetParentID() == 0 ? kPrimaryProton : kSecondaryProton;
+  if (particle == G4Electron::Definition())
+    return kElectrons;
+  // deuteron, triton, He3, alpha y GenericIon tienen A > 1
+  if (particle->GetBaryonNumber() > 1)
+    return kIons;
+  return kOther;
+}
+
+// ============================================================================
+// Fill() - Se llama en cada step dentro del phantom
+// ============================================================================
+void DepthDoseScorer::Fill(G4double localX, G4double edep, G4double stepLength,
+                           G4double weight, ParticleClass particleClass) {
+  if (fNBins == 0 || edep <= 0)
+    return;
+
+  G4int bin = G4int((localX + fHalfDepth) / fBinWidth);
+  if (bin < 0 || bin >= fNBins)
+    return;
+
+  fEdep[particleClass][bin] += weight * edep;
+
+  // LET solo para protones (primarios y secundarios)
+  if ((particleClass == kPrimaryProton || particleClass == kSecondaryProton) &&
+      stepLength > 0) {
+    G4double let = edep / stepLength;
+    fEdepLET[bin] += weight * edep * let;
+    fEdepProton[bin] += weight * edep;
+    fTrackLength[bin] += weight * stepLength;
+  }
+}
+
+// ============================================================================
+// Merge() - Mismo binning en todos los hilos, suma bin a bin
+// ============================================================================
+void DepthDoseScorer::Merge(const DepthDoseScorer &other) {
+  if (other.fNBins != fNBins)
+    return;
+  for (G4int b = 0; b < fNBins; b++) {
+    for (G4int c = 0; c < kNumClasses; c++)
+      fEdep[c][b] += other.fEdep[c][b];
+    fEdepLET[b] += other.fEdepLET[b];
+    fEdepProton[b] += other.fEdepProton[b];
+    fTrackLength[b] += other.fTrackLength[b];
+  }
+}
+
+// ============================================================================
+// Save() / Load() - Una linea por arreglo, precision completa
+// ============================================================================
+void DepthDoseScorer::Save(std::ostream &os) const {
+  os << fNBins << "\n" << std::setprecision(17);
+  auto write = [&](const std::vector<G4double> &v) {
+    for (G4double x : v)
+      os << x << " ";
+    os << "\n";
+  };
+  for (const auto &edep : fEdep)
+    write(edep);
+  write(fEdepLET);
+  write(fEdepProton);
+  write(fTrackLength);
+}
+
+G4bool DepthDoseScorer::Load(std::istream &is) {
+  G4int nBins = -1;
+  if (!(is >> nBins) || nBins != fNBins)
+    return false;
+  auto read = [&](std::vector<G4double> &v) {
+    for (G4double &x : v)
+      if (!(is >> x))
+        return false;
+    return true;
+  };
+  for (auto &edep : fEdep)
+    if (!read(edep))
+      return false;
+  return read(fEdepLET) && read(fEdepProton) && read(fTrackLength);
+}
+
+// ============================================================================
+// WriteHistograms() - Profundidad en cm desde la cara de entrada del phantom
+// ============================================================================
+void DepthDoseScorer::WriteHistograms(G4int nEvents) const {
+  if (fNBins == 0 || nEvents <= 0)
+    return;
+
+  const G4double depth = 2.0 * fHalfDepth / cm;
+  const G4double toGy = 1.0 / (fMassPerBin * nEvents * gray);
+
+  const char *names[kNumClasses] = {
+      "depth_dose_primary_p", "depth_dose_secondary_p", "depth_dose_ions",
+      "depth_dose_electrons", "depth_dose_other"};
+  const char *titles[kNumClasses] = {"Protones primarios",
+                                     "Protones secundarios", "Alfas e iones",
+                                     "Electrones", "Otras particulas"};
+
+  // Los histogramas quedan en el directorio actual (el TFile del run)
+  TH1D *hTotal = new TH1D("depth_dose_total",
+                          "Dosis total;Profundidad (cm);Dosis (Gy/primario)",
+                          fNBins, 0, depth);
+  for (G4int c = 0; c < kNumClasses; c++) {
+    TH1D *h = new TH1D(
+        names[c],
+        (G4String(titles[c]) + ";Profundidad (cm);Dosis (Gy/primario)").c_str(),
+        fNBins, 0, depth);
+    for (G4int b = 0; b < fNBins; b++) {
+      h->SetBinContent(b + 1, fEdep[c][b] * toGy);
+      hTotal->AddBinContent(b + 1, fEdep[c][b] * toGy);
+    }
+  }
+
+  TH1D *hLETd = new TH1D(
+      "depth_LETd", "LET_{d} protones;Profundidad (cm);LET_{d} (keV/#mum)",
+      fNBins, 0, depth);
+  TH1D *hLETt = new TH1D(
+      "depth_LETt", "LET_{t} protones;Profundidad (cm);LET_{t} (keV/#mum)",
+      fNBins, 0, depth);
+  const G4double letUnit = keV / um;
+  for (G4int b = 0; b < fNBins; b++) {
+    if (fEdepProton[b] > 0)
+      hLETd->SetBinContent(b + 1, fEdepLET[b] / fEdepProton[b] / letUnit);
+    if (fTrackLength[b] > 0)
+      hLETt->SetBinContent(b + 1, fEdepProton[b] / fTrackLength[b] / letUnit);
+  }
+}
@@ -0,0 +1,21 @@
+// ============================================================================
+// EventAction.cc - Final de evento: checkpoints periodicos
+// ============================================================================
+
+#include "EventAction.hh"
+#include "RunAction.hh"
+
+// ===== Constructor =====
+EventAction::EventAction(RunAction *runAction) : fRunAction(runAction) {}
+
+// ===== Destructor =====
+EventAction::~EventAction() {}
+
+// ============================================================================
+// EndOfEventAction() - El evento ya esta completo en tallies y scorers
+// ============================================================================
+void EventAction::EndOfEventAction(const G4Event *) {
+  if (fRunAction) {
+    fRunAction->EndOfEvent();
+  }
+}
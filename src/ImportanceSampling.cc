@@ -0,0 +1,250 @@
+// ============================================================================
+// ImportanceSampling.cc - Splitting y ruleta rusa geometricos
+// ============================================================================
+
+#include "ImportanceSampling.hh"
+#include "ImportanceSamplingMessenger.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// ===== Constructor: por defecto neutrones y gammas, sin celdas =====
+ImportanceSampling::ImportanceSampling()
+    : fMessenger(nullptr), fActive(false), fGeometry(kNone),
+      fCentre(10.0 * cm, 0, 0), fParticlesResolved(false),
+      fAllParticles(false) {
+  fParticleNames = {"neutron", "gamma"};
+
+  // Comandos /phantom/vr/
+  fMessenger = new ImportanceSamplingMessenger(this);
+}
+
+// ===== Destructor =====
+ImportanceSampling::~ImportanceSampling() { delete fMessenger; }
+
+// ============================================================================
+// Setters - Cada cambio revalida la configuracion
+// ============================================================================
+void ImportanceSampling::SetGeometry(CellGeometry geometry) {
+  fGeometry = geometry;
+  Update();
+}
+
+void ImportanceSampling::SetBoundaries(
+    const std::vector<G4double> &boundaries) {
+  fBoundaries = boundaries;
+  Update();
+}
+
+void ImportanceSampling::SetImportances(
+    const std::vector<G4double> &importances) {
+  fImportances = importances;
+  Update();
+}
+
+void ImportanceSampling::SetParticles(const std::vector<G4String> &names) {
+  fParticleNames = names;
+  fParticlesResolved = false;
+}
+
+// ============================================================================
+// Update() - Activo solo con n fronteras y n + 1 importancias
+// ============================================================================
+void ImportanceSampling::Update() {
+  fActive = false;
+  if (fGeometry == kNone || fBoundaries.empty() || fImportances.empty())
+    return;
+
+  if (fImportances.size() != fBoundaries.size() + 1) {
+    G4Exception("ImportanceSampling::Update", "VR001", JustWarning,
+                "Se necesitan n + 1 importancias para n fronteras: "
+                "splitting/ruleta desactivado");
+    return;
+  }
+  fActive = true;
+}
+
+// ============================================================================
+// CellIndex() - Numero de fronteras por debajo de la coordenada de celda
+// ============================================================================
+G4int ImportanceSampling::CellIndex(const G4ThreeVector &position) const {
+  G4double u = 0;
+  switch (fGeometry) {
+  case kPlanes:
+    u = position.x();
+    break;
+  case kCylinders:
+    u = std::hypot(position.y(), position.z());
+    break;
+  case kSpheres:
+    u = (position - fCentre).mag();
+    break;
+  default:
+    return 0;
+  }
+  return G4int(std::upper_bound(fBoundaries.begin(), fBoundaries.end(), u) -
+               fBoundaries.begin());
+}
+
+// ============================================================================
+// IsBiased() - Pocas particulas: busqueda lineal sobre punteros
+// ============================================================================
+G4bool ImportanceSampling::IsBiased(const G4ParticleDefinition *particle) {
+  if (!fParticlesResolved) {
+    fAllParticles = false;
+    fParticles.clear();
+    G4ParticleTable *table = G4ParticleTable::GetParticleTable();
+    for (const G4String &name : fParticleNames) {
+      if (name == "all") {
+        fAllParticles = true;
+        continue;
+      }
+      G4ParticleDefinition *definition = table->FindParticle(name);
+      if (definition) {
+        fParticles.push_back(definition);
+      } else {
+        G4Exception("ImportanceSampling::IsBiased", "VR002", JustWarning,
+                    ("Particula desconocida: " + name).c_str());
+      }
+    }
+    fParticlesResolved = true;
+  }
+
+  return fAllParticles || std::find(fParticles.begin(), fParticles.end(),
+                                    particle) != fParticles.end();
+}
+
+// ===== Peso nuevo en el track y en el post-step (sera el pre-step siguiente)
+static void UpdateWeight(G4Track *track, G4StepPoint *postPoint,
+                         G4double weight) {
+  track->SetWeight(weight);
+  postPoint->SetWeight(weight);
+}
+
+// ============================================================================
+// Apply() - Se llama al final de cada step, despues de acumular con el peso
+// ============================================================================
+void ImportanceSampling::Apply(const G4Step *step,
+                               G4TrackVector *secondaries) {
+  if (!fActive)
+    return;
+
+  G4Track *track = step->GetTrack();
+  if (track->GetTrackStatus() != fAlive || !IsBiased(track->GetDefinition()))
+    return;
+
+  const G4StepPoint *prePoint = step->GetPreStepPoint();
+  G4StepPoint *postPoint = step->GetPostStepPoint();
+  G4int cellPre = CellIndex(prePoint->GetPosition());
+  G4int cellPost = CellIndex(postPoint->GetPosition());
+  if (cellPre == cellPost)
+    return;
+
+  G4double importancePre = fImportances[cellPre];
+  G4double importancePost = fImportances[cellPost];
+  if (importancePre <= 0)
+    return;
+
+  G4double ratio = importancePost / importancePre;
+  G4double weight = track->GetWeight();
+
+  // ===== Ruleta rusa: celda menos importante (I = 0 mata siempre) =====
+  if (ratio < 1) {
+    if (G4UniformRand() < ratio) {
+      UpdateWeight(track, postPoint, weight / ratio);
+    } else {
+      track->SetTrackStatus(fStopAndKill); // los secundarios del step siguen
+    }
+    return;
+  }
+
+  // ===== Splitting: floor(R) copias, una mas con probabilidad frac(R) =====
+  G4int nCopies = G4int(ratio);
+  if (G4UniformRand() < ratio - nCopies)
+    nCopies++;
+
+  G4double newWeight = weight / ratio;
+  UpdateWeight(track, postPoint, newWeight);
+  for (G4int i = 1; i < nCopies; i++) {
+    G4Track *copy = new G4Track(
+        new G4DynamicParticle(*track->GetDynamicParticle()),
+        track->GetGlobalTime(), track->GetPosition());
+    copy->SetWeight(newWeight);
+    // Mismo padre que el original: para los scorers es la misma particula
+    copy->SetParentID(track->GetParentID());
+    copy->SetCreatorProcess(track->GetCreatorProcess());
+    copy->SetTouchableHandle(postPoint->GetTouchableHandle());
+    secondaries->push_back(copy);
+  }
+}
+
+// ============================================================================
+// Save() / Matches() - Solo importa la configuracion si esta activa
+// ============================================================================
+void ImportanceSampling::Save(std::ostream &os) const {
+  os << (fActive ? 1 : 0) << "\n";
+  if (!fActive)
+    return;
+  os << G4int(fGeometry) << " " << std::setprecision(17) << fCentre.x() << " "
+     << fCentre.y() << " " << fCentre.z() << "\n";
+  for (const auto *values : {&fBoundaries, &fImportances}) {
+    os << values->size();
+    for (G4double x : *values)
+      os << " " << x;
+    os << "\n";
+  }
+  os << fParticleNames.size();
+  for (const G4String &name : fParticleNames)
+    os << " " << name;
+  os << "\n";
+}
+
+G4bool ImportanceSampling::Matches(std::istream &is) const {
+  auto same = [](G4double a, G4double b) {
+    return std::fabs(a - b) <= 1e-9 * (1.0 + std::fabs(b));
+  };
+
+  G4int active = -1;
+  if (!(is >> active) || active != (fActive ? 1 : 0))
+    return false;
+  if (!fActive)
+    return true;
+
+  G4int geometry = -1;
+  G4double x, y, z;
+  if (!(is >> geometry >> x >> y >> z) || geometry != G4int(fGeometry))
+    return false;
+  if (fGeometry == kSpheres && !(same(x, fCentre.x()) &&
+                                 same(y, fCentre.y()) && same(z, fCentre.z())))
+    return false;
+
+  for (const auto *values : {&fBoundaries, &fImportances}) {
+    std::size_t n = 0;
+    if (!(is >> n) || n != values->size())
+      return false;
+    for (G4double value : *values) {
+      G4double saved;
+      if (!(is >> saved) || !same(saved, value))
+        return false;
+    }
+  }
+
+  std::size_t nParticles = 0;
+  if (!(is >> nParticles) || nParticles != fParticleNames.size())
+    return false;
+  for (const G4String &name : fParticleNames) {
+    std::string saved;
+    if (!(is >> saved) || saved != name)
+      return false;
+  }
+  return true;
+}
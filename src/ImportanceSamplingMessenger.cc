@@ -0,0 +1,127 @@
+// ============================================================================
+// ImportanceSamplingMessenger.cc - Comandos /phantom/vr/
+// ============================================================================
+
+#include "ImportanceSamplingMessenger.hh"
+#include "ImportanceSampling.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIdirectory.hh"
+
+#include <sstream>
+#include <vector>
+
+// ===== Constructor: define los comandos =====
+ImportanceSamplingMessenger::ImportanceSamplingMessenger(
+    ImportanceSampling *sampling)
+    : fSampling(sampling) {
+  fVRDir = new G4UIdirectory("/phantom/vr/");
+  fVRDir->SetGuidance("Splitting y ruleta rusa por celdas de importancia");
+
+  // ===== /phantom/vr/geometry =====
+  fGeometryCmd = new G4UIcmdWithAString("/phantom/vr/geometry", this);
+  fGeometryCmd->SetGuidance("Forma de las celdas (coordenadas globales):");
+  fGeometryCmd->SetGuidance("  planes    = planos perpendiculares a X");
+  fGeometryCmd->SetGuidance("  cylinders = cilindros alrededor del eje X");
+  fGeometryCmd->SetGuidance("  spheres   = esferas alrededor de centre");
+  fGeometryCmd->SetGuidance("  none      = transporte analogo");
+  fGeometryCmd->SetParameterName("geometry", false);
+  fGeometryCmd->SetCandidates("none planes cylinders spheres");
+  fGeometryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/vr/boundaries =====
+  fBoundariesCmd = new G4UIcmdWithAString("/phantom/vr/boundaries", this);
+  fBoundariesCmd->SetGuidance("Fronteras de las celdas en cm, crecientes");
+  fBoundariesCmd->SetGuidance("n fronteras -> n + 1 celdas");
+  fBoundariesCmd->SetParameterName("boundaries", false);
+  fBoundariesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/vr/importances =====
+  fImportancesCmd = new G4UIcmdWithAString("/phantom/vr/importances", this);
+  fImportancesCmd->SetGuidance("Importancia de cada celda (n + 1 valores)");
+  fImportancesCmd->SetGuidance("Ej: 1 2 4 8 16   (0 = matar al entrar)");
+  fImportancesCmd->SetParameterName("importances", false);
+  fImportancesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/vr/centre =====
+  fCentreCmd = new G4UIcmdWith3VectorAndUnit("/phantom/vr/centre", this);
+  fCentreCmd->SetGuidance("Centro de las celdas esfericas");
+  fCentreCmd->SetGuidance("Por defecto el centro del phantom (10, 0, 0) cm");
+  fCentreCmd->SetParameterName("x", "y", "z", false);
+  fCentreCmd->SetDefaultUnit("cm");
+  fCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/vr/particles =====
+  fParticlesCmd = new G4UIcmdWithAString("/phantom/vr/particles", this);
+  fParticlesCmd->SetGuidance("Particulas sesgadas (por defecto neutron gamma)");
+  fParticlesCmd->SetGuidance("\"all\" = todas las particulas");
+  fParticlesCmd->SetParameterName("particles", false);
+  fParticlesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+// ===== Destructor =====
+ImportanceSamplingMessenger::~ImportanceSamplingMessenger() {
+  delete fGeometryCmd;
+  delete fBoundariesCmd;
+  delete fImportancesCmd;
+  delete fCentreCmd;
+  delete fParticlesCmd;
+  delete fVRDir;
+}
+
+// ============================================================================
+// SetNewValue() - Geant4 lo llama cuando se ejecuta un comando
+// ============================================================================
+void ImportanceSamplingMessenger::SetNewValue(G4UIcommand *command,
+                                              G4String newValue) {
+  if (command == fGeometryCmd) {
+    ImportanceSampling::CellGeometry geometry = ImportanceSampling::kNone;
+    if (newValue == "planes")
+      geometry = ImportanceSampling::kPlanes;
+    else if (newValue == "cylinders")
+      geometry = ImportanceSampling::kCylinders;
+    else if (newValue == "spheres")
+      geometry = ImportanceSampling::kSpheres;
+    fSampling->SetGeometry(geometry);
+  } else if (command == fBoundariesCmd) {
+    // Fronteras en cm, estrictamente crecientes
+    std::vector<G4double> boundaries;
+    std::istringstream is(newValue);
+    G4double b;
+    while (is >> b)
+      boundaries.push_back(b * cm);
+    G4bool valid = !boundaries.empty();
+    for (std::size_t i = 1; i < boundaries.size() && valid; i++)
+      valid = boundaries[i] > boundaries[i - 1];
+    if (!valid) {
+      G4cerr << "boundaries: se necesitan fronteras crecientes" << G4endl;
+      return;
+    }
+    fSampling->SetBoundaries(boundaries);
+  } else if (command == fImportancesCmd) {
+    std::vector<G4double> importances;
+    std::istringstream is(newValue);
+    G4double value;
+    G4bool valid = true;
+    while (is >> value) {
+      valid = valid && value >= 0;
+      importances.push_back(value);
+    }
+    if (!valid || importances.empty()) {
+      G4cerr << "importances: se necesitan valores >= 0" << G4endl;
+      return;
+    }
+    fSampling->SetImportances(importances);
+  } else if (command == fCentreCmd) {
+    fSampling->SetCentre(fCentreCmd->GetNew3VectorValue(newValue));
+  } else if (command == fParticlesCmd) {
+    std::vector<G4String> names;
+    std::istringstream is(newValue);
+    std::string name;
+    while (is >> name)
+      names.push_back(name);
+    fSampling->SetParticles(names);
+  }
+}
@@ -0,0 +1,281 @@
+// ============================================================================
+// ProcessTally.cc - Contadores en linea por proceso, particula y volumen
+// ============================================================================
+
+#include "ProcessTally.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+
+// ===== Constructor =====
+// Capacidad inicial suficiente para QGSP_BIC en este setup; si aparece algo
+// nuevo el arreglo crece solo
+ProcessTally::ProcessTally()
+    : fCapProcesses(32), fCapParticles(32), fCapVolumes(4) {
+  fCells.resize(fCapProcesses * fCapParticles * fCapVolumes);
+}
+
+// ===== Destructor =====
+ProcessTally::~ProcessTally() {}
+
+// ============================================================================
+// Registry
+// ============================================================================
+G4int ProcessTally::Registry::Find(const void *key) {
+  if (key == lastKey && lastIndex >= 0)
+    return lastIndex;
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] == key) {
+      lastKey = key;
+      lastIndex = keyIndex[i];
+      return lastIndex;
+    }
+  }
+  return -1;
+}
+
+G4int ProcessTally::Registry::FindByName(const G4String &name) const {
+  for (std::size_t i = 0; i < names.size(); i++) {
+    if (names[i] == name)
+      return G4int(i);
+  }
+  return -1;
+}
+
+G4int ProcessTally::Registry::Add(const G4String &name) {
+  names.push_back(name);
+  return G4int(names.size()) - 1;
+}
+
+G4int ProcessTally::Registry::Bind(const void *key, const G4String &name) {
+  G4int i = FindByName(name);
+  if (i < 0)
+    i = Add(name);
+  keys.push_back(key);
+  keyIndex.push_back(i);
+  lastKey = key;
+  lastIndex = i;
+  return i;
+}
+
+// ============================================================================
+// Reserve() - Re-mapea las celdas a un arreglo con mas capacidad
+// ============================================================================
+void ProcessTally::Reserve(G4int nProc, G4int nPart, G4int nVol) {
+  if (nProc <= fCapProcesses && nPart <= fCapParticles && nVol <= fCapVolumes)
+    return;
+
+  G4int capProc = fCapProcesses, capPart = fCapParticles, capVol = fCapVolumes;
+  while (capProc < nProc)
+    capProc *= 2;
+  while (capPart < nPart)
+    capPart *= 2;
+  while (capVol < nVol)
+    capVol *= 2;
+
+  // Las entradas recien registradas (indice >= capacidad vieja) aun no
+  // tienen datos, solo copiamos las que caben en el arreglo viejo
+  std::vector<Cell> cells(capProc * capPart * capVol);
+  for (G4int v = 0; v < std::min(fVolumes.Size(), fCapVolumes); v++)
+    for (G4int p = 0; p < std::min(fParticles.Size(), fCapParticles); p++)
+      for (G4int q = 0; q < std::min(fProcesses.Size(), fCapProcesses); q++)
+        cells[(v * capPart + p) * capProc + q] = fCells[CellIndex(q, p, v)];
+
+  fCells.swap(cells);
+  fCapProcesses = capProc;
+  fCapParticles = capPart;
+  fCapVolumes = capVol;
+}
+
+// ============================================================================
+// Fill() - Se llama en cada step (camino critico: sin strings)
+// ============================================================================
+void ProcessTally::Fill(const G4VProcess *process,
+                        const G4ParticleDefinition *particle,
+                        const G4VPhysicalVolume *volume, G4double edep,
+                        G4int nSecondaries, G4double weight) {
+  G4int iProc = fProcesses.Find(process);
+  if (iProc < 0)
+    iProc = fProcesses.Bind(process,
+                            process ? process->GetProcessName() : "undefined");
+
+  G4int iPart = fParticles.Find(particle);
+  if (iPart < 0)
+    iPart = fParticles.Bind(particle, particle ? particle->GetParticleName()
+                                               : "undefined");
+
+  G4int iVol = fVolumes.Find(volume);
+  if (iVol < 0)
+    iVol = fVolumes.Bind(volume, volume ? volume->GetName() : "undefined");
+
+  Reserve(fProcesses.Size(), fParticles.Size(), fVolumes.Size());
+
+  Cell &cell = fCells[CellIndex(iProc, iPart, iVol)];
+  cell.steps++;
+  cell.edep += weight * edep;
+  cell.secondaries += weight * nSecondaries;
+}
+
+// ============================================================================
+// Merge() - Los G4VProcess son distintos en cada hilo, por eso emparejamos
+// por nombre y no por puntero
+// ============================================================================
+void ProcessTally::Merge(const ProcessTally &other) {
+  std::vector<G4int> mapProc(other.fProcesses.Size());
+  std::vector<G4int> mapPart(other.fParticles.Size());
+  std::vector<G4int> mapVol(other.fVolumes.Size());
+
+  auto match = [](Registry &mine, const Registry &theirs,
+                  std::vector<G4int> &map) {
+    for (G4int i = 0; i < theirs.Size(); i++) {
+      G4int j = mine.FindByName(theirs.names[i]);
+      map[i] = j >= 0 ? j : mine.Add(theirs.names[i]);
+    }
+  };
+  match(fProcesses, other.fProcesses, mapProc);
+  match(fParticles, other.fParticles, mapPart);
+  match(fVolumes, other.fVolumes, mapVol);
+
+  Reserve(fProcesses.Size(), fParticles.Size(), fVolumes.Size());
+
+  for (G4int v = 0; v < other.fVolumes.Size(); v++)
+    for (G4int p = 0; p < other.fParticles.Size(); p++)
+      for (G4int q = 0; q < other.fProcesses.Size(); q++) {
+        const Cell &src = other.fCells[other.CellIndex(q, p, v)];
+        if (src.steps == 0)
+          continue;
+        Cell &dst = fCells[CellIndex(mapProc[q], mapPart[p], mapVol[v])];
+        dst.steps += src.steps;
+        dst.edep += src.edep;
+        dst.secondaries += src.secondaries;
+      }
+}
+
+// ============================================================================
+// Reset()
+// ============================================================================
+void ProcessTally::Reset() {
+  std::fill(fCells.begin(), fCells.end(), Cell());
+}
+
+// ============================================================================
+// Save() / Load() - Formato: nombres (uno por linea) y celdas no vacias
+// ============================================================================
+void ProcessTally::Save(std::ostream &os) const {
+  const Registry *registries[3] = {&fProcesses, &fParticles, &fVolumes};
+  for (const Registry *reg : registries) {
+    os << reg->Size() << "\n";
+    for (const G4String &name : reg->names)
+      os << name << "\n";
+  }
+
+  G4long nCells = 0;
+  for (const Cell &c : fCells)
+    nCells += (c.steps > 0);
+  os << nCells << "\n" << std::setprecision(17);
+  for (G4int v = 0; v < fVolumes.Size(); v++)
+    for (G4int p = 0; p < fParticles.Size(); p++)
+      for (G4int q = 0; q < fProcesses.Size(); q++) {
+        const Cell &c = fCells[CellIndex(q, p, v)];
+        if (c.steps > 0)
+          os << q << " " << p << " " << v << " " << c.steps << " " << c.edep
+             << " " << c.secondaries << "\n";
+      }
+}
+
+G4bool ProcessTally::Load(std::istream &is) {
+  *this = ProcessTally();
+  Registry *registries[3] = {&fProcesses, &fParticles, &fVolumes};
+  for (Registry *reg : registries) {
+    G4int n = 0;
+    if (!(is >> n))
+      return false;
+    is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    for (G4int i = 0; i < n; i++) {
+      std::string name;
+      std::getline(is, name);
+      reg->Add(name);
+    }
+  }
+  Reserve(fProcesses.Size(), fParticles.Size(), fVolumes.Size());
+
+  G4long nCells = 0;
+  if (!(is >> nCells))
+    return false;
+  for (G4long i = 0; i < nCells; i++) {
+    G4int q, p, v;
+    Cell c;
+    if (!(is >> q >> p >> v >> c.steps >> c.edep >> c.secondaries))
+      return false;
+    if (q < 0 || q >= fProcesses.Size() || p < 0 || p >= fParticles.Size() ||
+        v < 0 || v >= fVolumes.Size())
+      return false;
+    fCells[CellIndex(q, p, v)] = c;
+  }
+  return true;
+}
+
+// ============================================================================
+// WriteSummary() - Mismo formato de tabla que process_analysis.C
+// ============================================================================
+void ProcessTally::WriteSummary(std::ostream &os) const {
+  const G4int nProc = fProcesses.Size();
+  const G4int nPart = fParticles.Size();
+  const G4int nVol = fVolumes.Size();
+
+  // ===== Totales marginales =====
+  std::vector<Cell> byProc(nProc), byPart(nPart), byVol(nVol);
+  for (G4int v = 0; v < nVol; v++)
+    for (G4int p = 0; p < nPart; p++)
+      for (G4int q = 0; q < nProc; q++) {
+        const Cell &c = fCells[CellIndex(q, p, v)];
+        for (Cell *m : {&byProc[q], &byPart[p], &byVol[v]}) {
+          m->steps += c.steps;
+          m->edep += c.edep;
+          m->secondaries += c.secondaries;
+        }
+      }
+
+  char line[160];
+  auto table = [&](const char *title, const char *column,
+                   const Registry &reg, const std::vector<Cell> &totals) {
+    os << "\n--- " << title << " ---\n";
+    std::snprintf(line, sizeof(line), "%-21s | %12s | %16s | %12s\n", column,
+                  "Steps", "Total Edep (MeV)", "Secondaries");
+    os << line;
+    os << "----------------------|--------------|------------------|----------"
+          "----\n";
+    for (G4int i = 0; i < reg.Size(); i++) {
+      std::snprintf(line, sizeof(line), "%-21s | %12lld | %16.3f | %12.2f\n",
+                    reg.names[i].c_str(), (long long)totals[i].steps,
+                    totals[i].edep, totals[i].secondaries);
+      os << line;
+    }
+  };
+
+  table("PHYSICS PROCESSES", "Process Name", fProcesses, byProc);
+  table("PARTICLE TYPES", "Particle Name", fParticles, byPart);
+  table("VOLUMES", "Volume Name", fVolumes, byVol);
+
+  // ===== Desglose completo (solo celdas no vacias) =====
+  os << "\n--- BREAKDOWN (volume / particle / process) ---\n";
+  for (G4int v = 0; v < nVol; v++)
+    for (G4int p = 0; p < nPart; p++)
+      for (G4int q = 0; q < nProc; q++) {
+        const Cell &c = fCells[CellIndex(q, p, v)];
+        if (c.steps == 0)
+          continue;
+        std::snprintf(line, sizeof(line),
+                      "%-14s %-14s %-21s | %12lld | %16.3f | %12.2f\n",
+                      fVolumes.names[v].c_str(), fParticles.names[p].c_str(),
+                      fProcesses.names[q].c_str(), (long long)c.steps, c.edep,
+                      c.secondaries);
+        os << line;
+      }
+}
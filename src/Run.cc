@@ -0,0 +1,38 @@
+// ============================================================================
+// Run.cc - Run con tallies en linea
+// ============================================================================
+
+#include "Run.hh"
+
+// ===== Constructor =====
+Run::Run() {}
+
+// ===== Destructor =====
+Run::~Run() {}
+
+// ============================================================================
+// Merge() - Combina el Run de un worker (solo se usa en modo MT)
+// ============================================================================
+void Run::Merge(const G4Run *run) {
+  const Run *localRun = static_cast<const Run *>(run);
+  fProcessTally.Merge(localRun->fProcessTally);
+  fDepthDose.Merge(localRun->fDepthDose);
+  fCylindrical.Merge(localRun->fCylindrical);
+
+  // La clase base suma el numero de eventos
+  G4Run::Merge(run);
+}
+
+// ============================================================================
+// Save() / Load() - Siempre en el mismo orden
+// ============================================================================
+void Run::Save(std::ostream &os) const {
+  fProcessTally.Save(os);
+  fDepthDose.Save(os);
+  fCylindrical.Save(os);
+}
+
+G4bool Run::Load(std::istream &is) {
+  return fProcessTally.Load(is) && fDepthDose.Load(is) &&
+         fCylindrical.Load(is);
+}
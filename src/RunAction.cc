@@ -6,11 +6,16 @@
 // ============================================================================
 
 #include "RunAction.hh"
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+#include "RunActionMessenger.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <cstdio>
+
 // ============================================================================
 // HEADERS para GPS o ParticleGun (segun USE_GPS)
 // ============================================================================
@@ -24,22 +29,73 @@
 // ============================================================================
 
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
 
 // ===== Constructor =====
 RunAction::RunAction()
-    : fRootFile(nullptr), fTree(nullptr), fEventID(0), fTrackID(0),
-      fParentID(0), fPdgCode(0), fX_pre(0), fY_pre(0), fZ_pre(0), fX_post(0),
-      fY_post(0), fZ_post(0), fEdep(0), fKinE_pre(0), fKinE_post(0),
-      fStepLength(0), fBeamEnergy(0) {
+    : fMessenger(nullptr), fCurrentRun(nullptr), fWriteRawSteps(true),
+      fDepthBins(400), fCylDepthBins(400), fCylRadialBins(100),
+      fCylRMax(10.0 * cm), fCheckpointEvery(0), fEventsTotal(0),
+      fEventOffset(0), fResuming(false), fImportanceSampling(nullptr),
+      fRootFile(nullptr), fTree(nullptr),
+      fEventID(0), fTrackID(0), fParentID(0), fPdgCode(0), fX_pre(0),
+      fY_pre(0), fZ_pre(0), fX_post(0), fY_post(0), fZ_post(0), fEdep(0),
+      fKinE_pre(0), fKinE_post(0), fStepLength(0), fWeight(1),
+      fBeamEnergy(0) {
   fParticleName[0] = '\0';
   fProcessName[0] = '\0';
   fVolumeName[0] = '\0';
+
+  // Comandos /phantom/output/, /phantom/score/ y /phantom/checkpoint/
+  fMessenger = new RunActionMessenger(this);
 }
 
 // ===== Destructor =====
-RunAction::~RunAction() {}
+RunAction::~RunAction() { delete fMessenger; }
+
+// ============================================================================
+// GenerateRun() - Geant4 lo llama antes de BeginOfRunAction()
+// ============================================================================
+G4Run *RunAction::GenerateRun() {
+  Run *run = new Run();
+  fCurrentRun = run;
+
+  // Scorer de dosis/LET sobre el phantom (400 bins = 1 mm por defecto)
+  const DetectorConstruction *detector =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (!detector || !detector->GetPhantomLogical())
+    return run;
+
+  if (fDepthBins > 0) {
+    run->GetDepthDoseScorer().Configure(fDepthBins,
+                                        detector->GetPhantomLogical());
+  }
+
+  // Scorer cilindrico (r, x): 1 mm x 1 mm hasta r = 10 cm por defecto
+  if (fCylDepthBins > 0) {
+    std::vector<G4double> edges = fCylRadialEdges;
+    if (edges.empty()) {
+      for (G4int i = 0; i <= fCylRadialBins; i++)
+        edges.push_back(fCylRMax * i / fCylRadialBins);
+    }
+    run->GetCylindricalScorer().Configure(fCylDepthBins, edges,
+                                          detector->GetPhantomLogical());
+  }
+
+  // Reanudando: tallies, scorers, contador de eventos y RNG del checkpoint.
+  // No hay numeros aleatorios entre este punto y el primer evento
+  if (fResuming && !Checkpoint::Read(fResumeFile, fResumeInfo, run,
+                                     fImportanceSampling)) {
+    G4Exception("RunAction::GenerateRun", "Checkpoint001", FatalException,
+                "No se pudo restaurar el checkpoint: use la misma "
+                "configuracion de /phantom/score/ y /phantom/vr/ que el "
+                "run original");
+  }
+  return run;
+}
 
 // ============================================================================
 // BeginOfRunAction() - Crea archivo ROOT con nombre dinamico
@@ -91,52 +147,119 @@ void RunAction::BeginOfRunAction(const G4Run *run) {
   G4int runID = run->GetRunID();
 
   // ===== Generar nombre del archivo (en carpeta output/) =====
-  std::ostringstream filename;
-  filename << "output/raw_" << std::fixed << std::setprecision(0) << fBeamEnergy
-           << "MeV_" << nEvents << "evts_run" << runID << ".root";
+  std::ostringstream tag;
+  tag << std::fixed << std::setprecision(0) << fBeamEnergy << "MeV_" << nEvents
+      << "evts_run" << runID;
+  fOutputTag = tag.str();
+
+  std::string fileName = "output/raw_" + fOutputTag + ".root";
+  fEventsTotal = nEvents;
+  fEventOffset = 0;
+
+  // ===== Reanudar: mismo archivo y etiqueta que el run interrumpido =====
+  if (fResuming) {
+    fBeamEnergy = fResumeInfo.beamEnergy;
+    fOutputTag = fResumeInfo.outputTag;
+    fileName = fResumeInfo.rootFileName;
+    fEventsTotal = fResumeInfo.eventsTotal;
+    fEventOffset = fResumeInfo.eventsDone;
+  }
+  fCheckpointName = "output/checkpoint_" + fOutputTag + ".chk";
 
   G4cout << "========================================" << G4endl;
   G4cout << " Iniciando Run #" << runID << G4endl;
   G4cout << " Energia del beam: " << fBeamEnergy << " MeV" << G4endl;
   G4cout << " Eventos programados: " << nEvents << G4endl;
-  G4cout << " Archivo de salida: " << filename.str() << G4endl;
+  G4cout << " Archivo de salida: " << fileName << G4endl;
+  if (fResuming) {
+    G4cout << " Reanudando desde: " << fResumeFile << " (" << fEventOffset
+           << "/" << fEventsTotal << " eventos hechos)" << G4endl;
+  }
   G4cout << "========================================" << G4endl;
 
-  // ===== Crear archivo ROOT =====
-  fRootFile = new TFile(filename.str().c_str(), "RECREATE");
+  // ===== Crear archivo ROOT (o reabrirlo al reanudar) =====
+  fRootFile = new TFile(fileName.c_str(), fResuming ? "UPDATE" : "RECREATE");
+  fTree = nullptr;
 
-  // ===== TTree con datos RAW =====
-  fTree = new TTree("raw_data", "Raw step data for manual analysis");
+  // ===== TTree con datos RAW (opcional, /phantom/output/rawSteps) =====
+  if (!fWriteRawSteps) {
+    G4cout << " TTree raw_data desactivado: solo scorers" << G4endl;
+    return;
+  }
+
+  if (fResuming) {
+    // El TTree guardado en el ultimo AutoSave; si tiene entradas de mas
+    // (corte entre el AutoSave y el checkpoint) nos quedamos con las
+    // primeras treeEntries, que son las del checkpoint
+    TTree *saved = dynamic_cast<TTree *>(fRootFile->Get("raw_data"));
+    if (!saved || saved->GetEntries() < fResumeInfo.treeEntries) {
+      G4Exception("RunAction::BeginOfRunAction", "Checkpoint002",
+                  FatalException,
+                  "raw_data no coincide con el checkpoint (faltan entradas)");
+      return;
+    }
+    if (saved->GetEntries() > fResumeInfo.treeEntries) {
+      fTree = saved->CloneTree(fResumeInfo.treeEntries);
+      delete saved;
+    } else {
+      fTree = saved;
+    }
+    ConnectRawBranches(false);
+  } else {
+    fTree = new TTree("raw_data", "Raw step data for manual analysis");
+    ConnectRawBranches(true);
+  }
+
+  // Con checkpoints el TTree solo se guarda en cada checkpoint: asi el
+  // archivo en disco siempre corresponde al ultimo estado guardado
+  if (fCheckpointEvery > 0) {
+    fTree->SetAutoSave(0);
+  }
+}
+
+// ============================================================================
+// ConnectRawBranches() - Ramas del TTree raw_data
+// ============================================================================
+void RunAction::ConnectRawBranches(G4bool create) {
+  auto connect = [&](const char *name, void *address, const char *leaflist) {
+    if (create) {
+      fTree->Branch(name, address, leaflist);
+    } else {
+      fTree->SetBranchAddress(name, address);
+    }
+  };
 
   // Ramas de identificacion
-  fTree->Branch("eventID", &fEventID, "eventID/I");
-  fTree->Branch("trackID", &fTrackID, "trackID/I");
-  fTree->Branch("parentID", &fParentID, "parentID/I");
+  connect("eventID", &fEventID, "eventID/I");
+  connect("trackID", &fTrackID, "trackID/I");
+  connect("parentID", &fParentID, "parentID/I");
 
   // Ramas de particula
-  fTree->Branch("particleName", fParticleName, "particleName/C");
-  fTree->Branch("pdgCode", &fPdgCode, "pdgCode/I");
+  connect("particleName", fParticleName, "particleName/C");
+  connect("pdgCode", &fPdgCode, "pdgCode/I");
 
   // Ramas de posicion (en cm)
-  fTree->Branch("x_pre", &fX_pre, "x_pre/D");
-  fTree->Branch("y_pre", &fY_pre, "y_pre/D");
-  fTree->Branch("z_pre", &fZ_pre, "z_pre/D");
-  fTree->Branch("x_post", &fX_post, "x_post/D");
-  fTree->Branch("y_post", &fY_post, "y_post/D");
-  fTree->Branch("z_post", &fZ_post, "z_post/D");
+  connect("x_pre", &fX_pre, "x_pre/D");
+  connect("y_pre", &fY_pre, "y_pre/D");
+  connect("z_pre", &fZ_pre, "z_pre/D");
+  connect("x_post", &fX_post, "x_post/D");
+  connect("y_post", &fY_post, "y_post/D");
+  connect("z_post", &fZ_post, "z_post/D");
 
   // Ramas de energia (en MeV)
-  fTree->Branch("edep", &fEdep, "edep/D");
-  fTree->Branch("kinE_pre", &fKinE_pre, "kinE_pre/D");
-  fTree->Branch("kinE_post", &fKinE_post, "kinE_post/D");
+  connect("edep", &fEdep, "edep/D");
+  connect("kinE_pre", &fKinE_pre, "kinE_pre/D");
+  connect("kinE_post", &fKinE_post, "kinE_post/D");
 
   // Rama de energia del beam (para referencia)
-  fTree->Branch("beamEnergy", &fBeamEnergy, "beamEnergy/D");
+  connect("beamEnergy", &fBeamEnergy, "beamEnergy/D");
 
   // Ramas de step
-  fTree->Branch("stepLength", &fStepLength, "stepLength/D");
-  fTree->Branch("processName", fProcessName, "processName/C");
-  fTree->Branch("volumeName", fVolumeName, "volumeName/C");
+  connect("stepLength", &fStepLength, "stepLength/D");
+  // Peso estadistico: histogramar con edep*weight (/phantom/vr/)
+  connect("weight", &fWeight, "weight/D");
+  connect("processName", fProcessName, "processName/C");
+  connect("volumeName", fVolumeName, "volumeName/C");
 }
 
 // ============================================================================
@@ -147,8 +270,19 @@ void RunAction::EndOfRunAction(const G4Run *run) {
   G4cout << " Run #" << run->GetRunID() << " completado" << G4endl;
   G4cout << " Eventos procesados: " << run->GetNumberOfEvent() << G4endl;
 
-  if (fRootFile && fTree) {
-    G4cout << " Entries en TTree: " << fTree->GetEntries() << G4endl;
+  const Run *phantomRun = static_cast<const Run *>(run);
+
+  if (fRootFile) {
+    if (fTree) {
+      G4cout << " Entries en TTree: " << fTree->GetEntries() << G4endl;
+    }
+
+    // Histogramas de dosis por clase y LET (Gy/primario, keV/um)
+    // y dosis cilindrica con IDD y penumbra
+    fRootFile->cd();
+    phantomRun->GetDepthDoseScorer().WriteHistograms(run->GetNumberOfEvent());
+    phantomRun->GetCylindricalScorer().WriteHistograms(
+        run->GetNumberOfEvent());
 
     fRootFile->Write();
     fRootFile->Close();
@@ -158,6 +292,25 @@ void RunAction::EndOfRunAction(const G4Run *run) {
 
     delete fRootFile;
     fRootFile = nullptr;
+    fTree = nullptr;
+  }
+
+  // El run termino: el checkpoint ya no sirve
+  std::remove(fCheckpointName.c_str());
+  fCurrentRun = nullptr;
+
+  // ===== Tabla de tallies (ya combinada si corremos en MT) =====
+  if (IsMaster()) {
+    std::string tallyName = "output/tally_" + fOutputTag + ".txt";
+    std::ofstream tallyFile(tallyName);
+    tallyFile << "=== PHYSICS PROCESS TALLY ===" << std::endl;
+    tallyFile << "Run: " << run->GetRunID() << std::endl;
+    tallyFile << "Events: " << run->GetNumberOfEvent() << std::endl;
+    tallyFile << "Weighted (sum of track weight): Total Edep, Secondaries"
+              << std::endl;
+    tallyFile << "Unweighted (simulated): Steps" << std::endl;
+    phantomRun->GetProcessTally().WriteSummary(tallyFile);
+    G4cout << " Tallies guardados en: " << tallyName << G4endl;
   }
 }
 
@@ -170,9 +323,9 @@ void RunAction::FillRawData(G4int eventID, G4int trackID, G4int parentID,
                             G4double x_post, G4double y_post, G4double z_post,
                             G4double edep, G4double kinE_pre,
                             G4double kinE_post, G4double stepLength,
-                            const G4String &processName,
+                            G4double weight, const G4String &processName,
                             const G4String &volumeName) {
-  fEventID = eventID;
+  fEventID = eventID + fEventOffset; // continua la numeracion al reanudar
   fTrackID = trackID;
   fParentID = parentID;
   fPdgCode = pdgCode;
@@ -196,8 +349,80 @@ void RunAction::FillRawData(G4int eventID, G4int trackID, G4int parentID,
   fKinE_post = kinE_post / MeV;
 
   fStepLength = stepLength / mm;
+  fWeight = weight;
 
   if (fTree) {
     fTree->Fill();
   }
 }
+
+// ============================================================================
+// EndOfEvent() - Checkpoint cada fCheckpointEvery eventos
+// ============================================================================
+void RunAction::EndOfEvent() {
+  if (fCheckpointEvery <= 0 || !fCurrentRun)
+    return;
+
+  // G4Run::RecordEvent() cuenta el evento despues de EndOfEventAction()
+  G4int eventsDone = fCurrentRun->GetNumberOfEvent() + 1;
+  if (eventsDone % fCheckpointEvery == 0 && eventsDone < fEventsTotal) {
+    WriteCheckpoint(eventsDone);
+  }
+}
+
+// ============================================================================
+// WriteCheckpoint() - Primero el TTree a disco, despues el checkpoint
+// ============================================================================
+void RunAction::WriteCheckpoint(G4int eventsDone) {
+  CheckpointInfo info;
+  info.outputTag = fOutputTag;
+  info.rootFileName = fRootFile ? fRootFile->GetName() : "";
+  info.beamEnergy = fBeamEnergy;
+  info.eventsTotal = fEventsTotal;
+  info.eventsDone = eventsDone;
+  info.rawSteps = (fTree != nullptr);
+
+  // Cabecera del TTree + buffers a disco: recuperable hasta aqui
+  if (fTree) {
+    fTree->AutoSave("SaveSelf");
+    info.treeEntries = fTree->GetEntries();
+  }
+
+  if (Checkpoint::Write(fCheckpointName, info, *fCurrentRun,
+                        fImportanceSampling)) {
+    G4cout << " Checkpoint: " << eventsDone << "/" << fEventsTotal
+           << " eventos -> " << fCheckpointName << G4endl;
+  } else {
+    G4Exception("RunAction::WriteCheckpoint", "Checkpoint003", JustWarning,
+                "No se pudo escribir el checkpoint");
+  }
+}
+
+// ============================================================================
+// ResumeFromCheckpoint() - /phantom/checkpoint/resume <archivo>
+// ============================================================================
+// La fuente (/gps/...), /phantom/score/ y /phantom/vr/ deben configurarse
+// igual que en el run original antes de este comando
+void RunAction::ResumeFromCheckpoint(const G4String &fileName) {
+  CheckpointInfo info;
+  if (!Checkpoint::Read(fileName, info, nullptr)) {
+    G4Exception("RunAction::ResumeFromCheckpoint", "Checkpoint004",
+                JustWarning, ("No se pudo leer " + fileName).c_str());
+    return;
+  }
+
+  G4int remaining = info.eventsTotal - info.eventsDone;
+  if (remaining <= 0) {
+    G4cout << " El checkpoint ya tiene todos los eventos" << G4endl;
+    return;
+  }
+
+  fResuming = true;
+  fResumeFile = fileName;
+  fResumeInfo = info;
+  fWriteRawSteps = info.rawSteps;
+
+  G4RunManager::GetRunManager()->BeamOn(remaining);
+
+  fResuming = false;
+}
@@ -0,0 +1,154 @@
+// ============================================================================
+// RunActionMessenger.cc - Comandos /phantom/ de salida y scoring
+// ============================================================================
+
+#include "RunActionMessenger.hh"
+#include "RunAction.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+#include <sstream>
+#include <vector>
+
+// ===== Constructor: define los comandos =====
+RunActionMessenger::RunActionMessenger(RunAction *runAction)
+    : fRunAction(runAction) {
+  fPhantomDir = new G4UIdirectory("/phantom/");
+  fPhantomDir->SetGuidance("Comandos de la simulacion del phantom");
+
+  fOutputDir = new G4UIdirectory("/phantom/output/");
+  fOutputDir->SetGuidance("Control de los archivos de salida");
+
+  fScoreDir = new G4UIdirectory("/phantom/score/");
+  fScoreDir->SetGuidance("Scorers acumulados durante el transporte");
+
+  // ===== /phantom/output/rawSteps =====
+  fRawStepsCmd = new G4UIcmdWithABool("/phantom/output/rawSteps", this);
+  fRawStepsCmd->SetGuidance("Guarda cada step en el TTree raw_data.");
+  fRawStepsCmd->SetGuidance("false = solo scorers y tallies (archivo pequeno)");
+  fRawStepsCmd->SetParameterName("enable", false);
+  fRawStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/score/depthBins =====
+  fDepthBinsCmd = new G4UIcmdWithAnInteger("/phantom/score/depthBins", this);
+  fDepthBinsCmd->SetGuidance("Bins de profundidad (X) del scorer de dosis/LET");
+  fDepthBinsCmd->SetGuidance("0 = desactivado");
+  fDepthBinsCmd->SetParameterName("nBins", false);
+  fDepthBinsCmd->SetRange("nBins >= 0");
+  fDepthBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/score/cyl/ =====
+  fCylDir = new G4UIdirectory("/phantom/score/cyl/");
+  fCylDir->SetGuidance("Scorer cilindrico (r, profundidad) sobre el eje X");
+
+  fCylDepthBinsCmd =
+      new G4UIcmdWithAnInteger("/phantom/score/cyl/depthBins", this);
+  fCylDepthBinsCmd->SetGuidance("Bins de profundidad (0 = desactivado)");
+  fCylDepthBinsCmd->SetParameterName("nBins", false);
+  fCylDepthBinsCmd->SetRange("nBins >= 0");
+  fCylDepthBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCylRadialBinsCmd =
+      new G4UIcmdWithAnInteger("/phantom/score/cyl/radialBins", this);
+  fCylRadialBinsCmd->SetGuidance("Numero de anillos de igual ancho hasta rMax");
+  fCylRadialBinsCmd->SetParameterName("nBins", false);
+  fCylRadialBinsCmd->SetRange("nBins > 0");
+  fCylRadialBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCylRMaxCmd = new G4UIcmdWithADoubleAndUnit("/phantom/score/cyl/rMax", this);
+  fCylRMaxCmd->SetGuidance("Radio maximo del scorer (anillos uniformes)");
+  fCylRMaxCmd->SetParameterName("rMax", false);
+  fCylRMaxCmd->SetRange("rMax > 0");
+  fCylRMaxCmd->SetDefaultUnit("cm");
+  fCylRMaxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCylRadialEdgesCmd =
+      new G4UIcmdWithAString("/phantom/score/cyl/radialEdges", this);
+  fCylRadialEdgesCmd->SetGuidance("Bordes radiales en cm, crecientes");
+  fCylRadialEdgesCmd->SetGuidance("Ej: 0 0.1 0.2 0.3 0.5 1 2 5 10");
+  fCylRadialEdgesCmd->SetGuidance("\"none\" vuelve a anillos uniformes");
+  fCylRadialEdgesCmd->SetParameterName("edges", false);
+  fCylRadialEdgesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // ===== /phantom/checkpoint/ =====
+  fCheckpointDir = new G4UIdirectory("/phantom/checkpoint/");
+  fCheckpointDir->SetGuidance("Checkpoints para reanudar runs largos");
+
+  fCheckpointEveryCmd =
+      new G4UIcmdWithAnInteger("/phantom/checkpoint/every", this);
+  fCheckpointEveryCmd->SetGuidance("Guarda un checkpoint cada n eventos");
+  fCheckpointEveryCmd->SetGuidance("en output/checkpoint_<tag>.chk");
+  fCheckpointEveryCmd->SetGuidance("0 = desactivado");
+  fCheckpointEveryCmd->SetParameterName("nEvents", false);
+  fCheckpointEveryCmd->SetRange("nEvents >= 0");
+  fCheckpointEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fResumeCmd = new G4UIcmdWithAString("/phantom/checkpoint/resume", this);
+  fResumeCmd->SetGuidance("Continua el run guardado en el checkpoint.");
+  fResumeCmd->SetGuidance("Antes: misma fuente (/gps/), /phantom/score/");
+  fResumeCmd->SetGuidance("y /phantom/vr/ que el run original");
+  fResumeCmd->SetParameterName("fileName", false);
+  fResumeCmd->AvailableForStates(G4State_Idle);
+}
+
+// ===== Destructor =====
+RunActionMessenger::~RunActionMessenger() {
+  delete fRawStepsCmd;
+  delete fDepthBinsCmd;
+  delete fCylDepthBinsCmd;
+  delete fCylRadialBinsCmd;
+  delete fCylRMaxCmd;
+  delete fCylRadialEdgesCmd;
+  delete fCheckpointEveryCmd;
+  delete fResumeCmd;
+  delete fCheckpointDir;
+  delete fCylDir;
+  delete fScoreDir;
+  delete fOutputDir;
+  delete fPhantomDir;
+}
+
+// ============================================================================
+// SetNewValue() - Geant4 lo llama cuando se ejecuta un comando
+// ============================================================================
+void RunActionMessenger::SetNewValue(G4UIcommand *command, G4String newValue) {
+  if (command == fRawStepsCmd) {
+    fRunAction->SetWriteRawSteps(fRawStepsCmd->GetNewBoolValue(newValue));
+  } else if (command == fDepthBinsCmd) {
+    fRunAction->SetDepthBins(fDepthBinsCmd->GetNewIntValue(newValue));
+  } else if (command == fCylDepthBinsCmd) {
+    fRunAction->SetCylDepthBins(fCylDepthBinsCmd->GetNewIntValue(newValue));
+  } else if (command == fCylRadialBinsCmd) {
+    fRunAction->SetCylRadialBins(fCylRadialBinsCmd->GetNewIntValue(newValue));
+  } else if (command == fCylRMaxCmd) {
+    fRunAction->SetCylRMax(fCylRMaxCmd->GetNewDoubleValue(newValue));
+  } else if (command == fCylRadialEdgesCmd) {
+    // Lista de bordes en cm, debe ser estrictamente creciente
+    std::vector<G4double> edges;
+    if (newValue != "none") {
+      std::istringstream is(newValue);
+      G4double r;
+      while (is >> r)
+        edges.push_back(r * cm);
+    }
+    G4bool valid = edges.empty() || (edges.size() >= 2 && edges[0] >= 0);
+    for (std::size_t i = 1; i < edges.size() && valid; i++)
+      valid = edges[i] > edges[i - 1];
+    if (!valid) {
+      G4cerr << "radialEdges: se necesitan >= 2 bordes crecientes desde r >= 0"
+             << G4endl;
+      return;
+    }
+    fRunAction->SetCylRadialEdges(edges);
+  } else if (command == fCheckpointEveryCmd) {
+    fRunAction->SetCheckpointEvery(
+        fCheckpointEveryCmd->GetNewIntValue(newValue));
+  } else if (command == fResumeCmd) {
+    fRunAction->ResumeFromCheckpoint(newValue);
+  }
+}
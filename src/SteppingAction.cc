@@ -7,22 +7,36 @@
 //   - Posicion (pre y post step)
 //   - Energia (depositada, cinetica pre/post)
 //   - Step (longitud, proceso fisico, volumen)
+// Ademas llena los tallies y scorers del Run (siempre activos); el TTree de
+// steps se puede apagar con /phantom/output/rawSteps false
+// Todo se acumula con el peso del track; al final del step se aplica el
+// splitting/ruleta de /phantom/vr/ (ImportanceSampling)
 // ============================================================================
 
 #include "SteppingAction.hh"
+#include "DetectorConstruction.hh"
+#include "Run.hh"
 #include "RunAction.hh"
 
 #include "G4Event.hh"
 #include "G4LogicalVolume.hh"
+#include "G4NavigationHistory.hh"
 #include "G4RunManager.hh"
 #include "G4Step.hh"
 #include "G4StepPoint.hh"
+#include "G4SteppingManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
 #include "G4VProcess.hh"
 
 // ===== Constructor =====
-SteppingAction::SteppingAction(RunAction *runAction) : fRunAction(runAction) {}
+SteppingAction::SteppingAction(RunAction *runAction)
+    : fRunAction(runAction), fScoringVolume(nullptr) {
+  // Los checkpoints guardan la configuracion de /phantom/vr/
+  if (fRunAction)
+    fRunAction->SetImportanceSampling(&fImportance);
+}
 
 // ===== Destructor =====
 SteppingAction::~SteppingAction() {}
@@ -31,35 +45,77 @@ SteppingAction::~SteppingAction() {}
 // UserSteppingAction() - Se llama en CADA paso de CADA particula
 // ============================================================================
 void SteppingAction::UserSteppingAction(const G4Step *step) {
-  // ===== 1. Obtener el track (particula) =====
+  // ===== 1. Obtener el track (particula) y los puntos pre/post =====
   G4Track *track = step->GetTrack();
+  G4StepPoint *prePoint = step->GetPreStepPoint();
+  G4StepPoint *postPoint = step->GetPostStepPoint();
+
+  G4double edep = step->GetTotalEnergyDeposit();
+  G4double stepLength = step->GetStepLength();
+  G4double weight = prePoint->GetWeight(); // 1 en transporte analogo
+
+  // Volumen del phantom (se pide una sola vez a DetectorConstruction)
+  if (!fScoringVolume) {
+    const DetectorConstruction *detector =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    fScoringVolume = detector->GetPhantomLogical();
+  }
+
+  // ===== 2. Tallies y scorers en linea (claves de puntero, sin strings) =====
+  Run *run = static_cast<Run *>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  G4VPhysicalVolume *preVolume =
+      prePoint->GetTouchable() ? prePoint->GetTouchable()->GetVolume()
+                               : nullptr;
+  if (run) {
+    G4int nSecondaries = G4int(step->GetSecondaryInCurrentStep()->size());
+    run->GetProcessTally().Fill(postPoint->GetProcessDefinedStep(),
+                                track->GetDefinition(), preVolume,
+                                edep / MeV, nSecondaries, weight);
+
+    // Scorers del phantom: punto medio del step en coordenadas locales
+    if (edep > 0 && preVolume &&
+        preVolume->GetLogicalVolume() == fScoringVolume) {
+      G4ThreeVector midPoint =
+          0.5 * (prePoint->GetPosition() + postPoint->GetPosition());
+      G4ThreeVector local = prePoint->GetTouchable()
+                                ->GetHistory()
+                                ->GetTopTransform()
+                                .TransformPoint(midPoint);
+      run->GetDepthDoseScorer().Fill(local.x(), edep, stepLength, weight,
+                                     DepthDoseScorer::Classify(track));
+      run->GetCylindricalScorer().Fill(local, weight * edep);
+    }
+  }
+
+  // Splitting/ruleta al cruzar celdas: cambia el peso para los steps que
+  // siguen; este step ya quedo acumulado con el peso anterior
+  fImportance.Apply(step, fpSteppingManager->GetfSecondary());
+
+  // Sin TTree de steps no hace falta armar los strings de abajo
+  if (!fRunAction || !fRunAction->GetWriteRawSteps())
+    return;
 
-  // ===== 2. Identificadores =====
+  // ===== 3. Identificadores =====
   G4int eventID =
       G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
   G4int trackID = track->GetTrackID();
   G4int parentID = track->GetParentID(); // 0 = particula primaria
 
-  // ===== 3. Informacion de la particula =====
+  // ===== 4. Informacion de la particula =====
   G4String particleName = track->GetDefinition()->GetParticleName();
   G4int pdgCode = track->GetDefinition()->GetPDGEncoding();
 
-  // ===== 4. Puntos pre y post step =====
-  G4StepPoint *prePoint = step->GetPreStepPoint();
-  G4StepPoint *postPoint = step->GetPostStepPoint();
-
-  // Posiciones
+  // ===== 5. Posiciones pre y post step =====
   G4ThreeVector prePos = prePoint->GetPosition();
   G4ThreeVector postPos = postPoint->GetPosition();
 
-  // ===== 5. Energia =====
-  G4double edep = step->GetTotalEnergyDeposit();
+  // ===== 6. Energia =====
   G4double kinE_pre = prePoint->GetKineticEnergy();
   G4double kinE_post = postPoint->GetKineticEnergy();
 
-  // ===== 6. Informacion del step =====
-  G4double stepLength = step->GetStepLength();
-
+  // ===== 7. Informacion del step =====
   // Proceso fisico que limito el step
   G4String processName = "undefined";
   if (postPoint->GetProcessDefinedStep()) {
@@ -68,15 +124,13 @@ void SteppingAction::UserSteppingAction(const G4Step *step) {
 
   // Volumen donde ocurrio
   G4String volumeName = "undefined";
-  if (prePoint->GetTouchable() && prePoint->GetTouchable()->GetVolume()) {
-    volumeName = prePoint->GetTouchable()->GetVolume()->GetName();
+  if (preVolume) {
+    volumeName = preVolume->GetName();
   }
 
-  // ===== 7. Llenar el TTree =====
-  if (fRunAction) {
-    fRunAction->FillRawData(eventID, trackID, parentID, particleName, pdgCode,
-                            prePos.x(), prePos.y(), prePos.z(), postPos.x(),
-                            postPos.y(), postPos.z(), edep, kinE_pre, kinE_post,
-                            stepLength, processName, volumeName);
-  }
+  // ===== 8. Llenar el TTree =====
+  fRunAction->FillRawData(eventID, trackID, parentID, particleName, pdgCode,
+                          prePos.x(), prePos.y(), prePos.z(), postPos.x(),
+                          postPos.y(), postPos.z(), edep, kinE_pre, kinE_post,
+                          stepLength, weight, processName, volumeName);
 }
@@ -0,0 +1,255 @@
+// ============================================================================
+// DoseComparison.cc - Indice gamma multihilo y DVH
+// ============================================================================
+// Busqueda gamma: como las mallas son regulares, la propia malla es el
+// indice espacial. Precalculamos una lista de desplazamientos ordenada por
+// distancia y para cada punto la recorremos de cerca a lejos; en cuanto la
+// distancia sola supera el mejor gamma encontrado paramos (ningun punto mas
+// lejano puede mejorarlo). Con gamma < 1 eso son pocos cientos de
+// interpolaciones por voxel en vez de recorrer toda la malla evaluada.
+// ============================================================================
+
+#include "DoseComparison.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+// ============================================================================
+// DoseGrid
+// ============================================================================
+double DoseGrid::Max() const {
+  double m = 0;
+  for (double d : dose)
+    m = std::max(m, d);
+  return m;
+}
+
+// ===== Coordenada fraccional en un eje (helper de Interpolate) =====
+// Ejes degenerados: siempre el bin 0 con peso completo
+static bool AxisLocate(double p, double c0, double d, int n, int &i0,
+                       double &f) {
+  if (n == 1) {
+    i0 = 0;
+    f = 0;
+    return true;
+  }
+  double u = (p - c0) / d;
+  const double eps = 1e-9;
+  if (u < -eps || u > (n - 1) + eps)
+    return false;
+  u = std::min(std::max(u, 0.0), double(n - 1));
+  i0 = std::min(int(u), n - 2);
+  f = u - i0;
+  return true;
+}
+
+bool DoseGrid::Interpolate(double x, double y, double z, double &value) const {
+  int i0, j0, k0;
+  double fx, fy, fz;
+  if (!AxisLocate(x, x0, dx, nx, i0, fx) ||
+      !AxisLocate(y, y0, dy, ny, j0, fy) || !AxisLocate(z, z0, dz, nz, k0, fz))
+    return false;
+
+  value = 0;
+  for (int c = 0; c < 8; c++) {
+    int di = c & 1, dj = (c >> 1) & 1, dk = (c >> 2) & 1;
+    double w = (di ? fx : 1 - fx) * (dj ? fy : 1 - fy) * (dk ? fz : 1 - fz);
+    if (w == 0)
+      continue; // tambien evita salirse en ejes degenerados
+    value += w * dose[Index(i0 + di, j0 + dj, k0 + dk)];
+  }
+  return true;
+}
+
+// ============================================================================
+// ComputeGamma()
+// ============================================================================
+namespace {
+struct Offset {
+  double dx, dy, dz;
+  double r2;
+};
+} // namespace
+
+GammaResult ComputeGamma(const DoseGrid &ref, const DoseGrid &eval,
+                         const GammaOptions &opt) {
+  GammaResult result;
+  result.gamma = ref;
+  std::fill(result.gamma.dose.begin(), result.gamma.dose.end(), -1.0);
+
+  const double dta = opt.dtaCriterion;
+  const double radius = opt.searchRadius > 0 ? opt.searchRadius : 3.0 * dta;
+  const double res = opt.resolution > 0 ? opt.resolution : dta / 5.0;
+  const double normDose = opt.normDose > 0 ? opt.normDose : ref.Max();
+  const double cutoff = opt.lowDoseCutoff * normDose;
+  if (normDose <= 0)
+    return result;
+
+  // ===== 1. Desplazamientos de busqueda ordenados por distancia =====
+  // Solo en los ejes no degenerados; paso = min(voxel evaluado, resolucion)
+  const int nAxis[3] = {eval.nx, eval.ny, eval.nz};
+  const double dAxis[3] = {eval.dx, eval.dy, eval.dz};
+  double step[3];
+  int nStep[3];
+  for (int a = 0; a < 3; a++) {
+    step[a] = std::min(dAxis[a], res);
+    nStep[a] = nAxis[a] > 1 ? int(radius / step[a]) : 0;
+  }
+
+  std::vector<Offset> offsets;
+  for (int k = -nStep[2]; k <= nStep[2]; k++)
+    for (int j = -nStep[1]; j <= nStep[1]; j++)
+      for (int i = -nStep[0]; i <= nStep[0]; i++) {
+        Offset o{i * step[0], j * step[1], k * step[2], 0};
+        o.r2 = o.dx * o.dx + o.dy * o.dy + o.dz * o.dz;
+        if (o.r2 <= radius * radius)
+          offsets.push_back(o);
+      }
+  std::sort(offsets.begin(), offsets.end(),
+            [](const Offset &a, const Offset &b) { return a.r2 < b.r2; });
+
+  const double dta2 = dta * dta;
+  const double gammaNotFound = radius / dta; // cota inferior si no hay match
+
+  // ===== 2. Evaluacion en paralelo por bloques de voxeles =====
+  const std::size_t nPoints = ref.Size();
+  const std::size_t chunk = 4096;
+  std::atomic<std::size_t> next(0);
+
+  int nThreads = opt.nThreads > 0 ? opt.nThreads
+                                  : int(std::thread::hardware_concurrency());
+  nThreads = std::max(1, nThreads);
+
+  struct Partial {
+    long nEvaluated = 0, nPassed = 0;
+    double sum = 0, max = 0;
+  };
+  std::vector<Partial> partials(nThreads);
+
+  auto worker = [&](int t) {
+    Partial &p = partials[t];
+    for (;;) {
+      std::size_t begin = next.fetch_add(chunk);
+      if (begin >= nPoints)
+        break;
+      std::size_t end = std::min(begin + chunk, nPoints);
+
+      for (std::size_t idx = begin; idx < end; idx++) {
+        // Gamma local sin dosis de referencia no tiene tolerancia definida
+        double dRef = ref.dose[idx];
+        if (dRef < cutoff || (opt.local && dRef <= 0))
+          continue;
+
+        int i = int(idx % ref.nx);
+        int j = int((idx / ref.nx) % ref.ny);
+        int k = int(idx / (std::size_t(ref.nx) * ref.ny));
+        double x = ref.x0 + i * ref.dx;
+        double y = ref.y0 + j * ref.dy;
+        double z = ref.z0 + k * ref.dz;
+
+        double tol = opt.doseCriterion * (opt.local ? dRef : normDose);
+        double tol2 = tol * tol;
+
+        double best2 = std::numeric_limits<double>::infinity();
+        for (const Offset &o : offsets) {
+          double dist2 = o.r2 / dta2;
+          if (dist2 >= best2)
+            break; // los siguientes estan aun mas lejos
+          double dEval;
+          if (!eval.Interpolate(x + o.dx, y + o.dy, z + o.dz, dEval))
+            continue;
+          // Diferencia nula = termino de dosis nulo (evita 0/0 con tol = 0)
+          double diff = dEval - dRef;
+          double g2 = diff == 0 ? dist2 : dist2 + diff * diff / tol2;
+          if (g2 < best2)
+            best2 = g2;
+        }
+
+        double g = std::isinf(best2) ? gammaNotFound : std::sqrt(best2);
+        result.gamma.dose[idx] = g;
+        p.nEvaluated++;
+        if (g <= 1.0)
+          p.nPassed++;
+        p.sum += g;
+        p.max = std::max(p.max, g);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < nThreads; t++)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &th : threads)
+    th.join();
+
+  // ===== 3. Reducir estadisticas =====
+  double sum = 0;
+  for (const Partial &p : partials) {
+    result.nEvaluated += p.nEvaluated;
+    result.nPassed += p.nPassed;
+    sum += p.sum;
+    result.maxGamma = std::max(result.maxGamma, p.max);
+  }
+  if (result.nEvaluated > 0) {
+    result.passRate = double(result.nPassed) / result.nEvaluated;
+    result.meanGamma = sum / result.nEvaluated;
+  }
+  return result;
+}
+
+// ============================================================================
+// DVH
+// ============================================================================
+DVH ComputeDVH(const DoseGrid &grid, int nBins, double maxDose,
+               const std::vector<char> *mask) {
+  DVH dvh;
+  if (nBins <= 0 || maxDose <= 0)
+    return dvh;
+
+  // Histograma diferencial y luego suma acumulada desde arriba
+  std::vector<double> diff(nBins, 0.0);
+  double total = 0;
+  double width = maxDose / nBins;
+  for (std::size_t idx = 0; idx < grid.Size(); idx++) {
+    if (mask && !(*mask)[idx])
+      continue;
+    int b = int(grid.dose[idx] / width);
+    b = std::min(std::max(b, 0), nBins - 1);
+    diff[b] += 1.0;
+    total += 1.0;
+  }
+
+  dvh.doseEdge.resize(nBins);
+  dvh.volume.resize(nBins);
+  double above = 0;
+  for (int b = nBins - 1; b >= 0; b--) {
+    above += diff[b];
+    dvh.doseEdge[b] = b * width;
+    dvh.volume[b] = total > 0 ? above / total : 0;
+  }
+  return dvh;
+}
+
+double DVH::DoseAtVolume(double fraction) const {
+  // volume es no creciente: el ultimo borde con volume >= fraction
+  double dose = 0;
+  for (std::size_t b = 0; b < volume.size(); b++) {
+    if (volume[b] >= fraction)
+      dose = doseEdge[b];
+    else
+      break;
+  }
+  return dose;
+}
+
+double DVH::VolumeAtDose(double dose) const {
+  for (std::size_t b = 0; b < doseEdge.size(); b++) {
+    if (doseEdge[b] >= dose)
+      return volume[b];
+  }
+  return 0;
+}
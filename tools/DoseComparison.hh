@@ -0,0 +1,85 @@
+// ============================================================================
+// DoseComparison.hh - Motor de comparacion de distribuciones de dosis
+// ============================================================================
+// Indice gamma (global/local, diferencia de dosis + DTA) e histogramas
+// dosis-volumen (DVH) sobre mallas regulares 1D/2D/3D.
+// NOTA: No depende de ROOT ni de Geant4, la lectura de archivos va en
+//       dose_compare.cc
+// ============================================================================
+
+#ifndef DOSE_COMPARISON_HH
+#define DOSE_COMPARISON_HH
+
+#include <cstddef>
+#include <vector>
+
+// ============================================================================
+// DoseGrid - Malla regular de dosis
+// Los ejes con un solo bin (n = 1) se consideran degenerados, asi una misma
+// estructura sirve para curvas de Bragg (1D), mapas (2D) y volumenes (3D)
+// ============================================================================
+struct DoseGrid {
+  int nx = 1, ny = 1, nz = 1;
+  double x0 = 0, y0 = 0, z0 = 0; // centro del primer voxel (cm)
+  double dx = 1, dy = 1, dz = 1; // tamano del voxel (cm)
+  std::vector<double> dose;      // indice = (k * ny + j) * nx + i
+
+  std::size_t Size() const { return std::size_t(nx) * ny * nz; }
+  std::size_t Index(int i, int j, int k) const {
+    return (std::size_t(k) * ny + j) * nx + i;
+  }
+  int Dimension() const { return (nx > 1) + (ny > 1) + (nz > 1); }
+  double Max() const;
+
+  // Interpolacion trilineal en (x, y, z) en cm
+  // Retorna false si el punto cae fuera de la malla
+  bool Interpolate(double x, double y, double z, double &value) const;
+};
+
+// ============================================================================
+// Parametros del indice gamma
+// ============================================================================
+struct GammaOptions {
+  double doseCriterion = 0.03; // fraccion: 0.03 = 3%
+  double dtaCriterion = 0.3;   // distance-to-agreement (cm)
+  bool local = false;          // true = gamma local (omite puntos con D = 0)
+  double lowDoseCutoff = 0.10; // ignora puntos con D < cutoff * Dnorm
+  double normDose = 0;         // 0 -> maximo de la referencia
+  double searchRadius = 0;     // cm, 0 -> 3 * DTA
+  double resolution = 0;       // paso de busqueda (cm), 0 -> DTA / 5
+  int nThreads = 0;            // 0 -> std::thread::hardware_concurrency()
+};
+
+struct GammaResult {
+  DoseGrid gamma; // misma malla que la referencia, -1 = no evaluado
+  long nEvaluated = 0;
+  long nPassed = 0;
+  double passRate = 0; // fraccion de puntos evaluados con gamma <= 1
+  double meanGamma = 0;
+  double maxGamma = 0;
+};
+
+// Calcula el indice gamma en cada voxel de la referencia buscando en la
+// distribucion evaluada. Ambas mallas deben tener la misma dimension y
+// estar en el mismo sistema de coordenadas (pueden tener binning distinto)
+GammaResult ComputeGamma(const DoseGrid &reference, const DoseGrid &evaluated,
+                         const GammaOptions &options);
+
+// ============================================================================
+// DVH acumulado: volume[b] = fraccion del volumen con dosis >= doseEdge[b]
+// ============================================================================
+struct DVH {
+  std::vector<double> doseEdge;
+  std::vector<double> volume;
+
+  // Dosis minima que recibe la fraccion de volumen dada (ej. D95 -> 0.95)
+  double DoseAtVolume(double fraction) const;
+  // Fraccion de volumen que recibe al menos la dosis dada (ej. V95)
+  double VolumeAtDose(double dose) const;
+};
+
+// mask: opcional, voxeles con mask[idx] != 0 forman la estructura
+DVH ComputeDVH(const DoseGrid &grid, int nBins, double maxDose,
+               const std::vector<char> *mask = nullptr);
+
+#endif // DOSE_COMPARISON_HH
@@ -0,0 +1,462 @@
+// ============================================================================
+// dose_compare.cc - Comparacion de distribuciones de dosis (gamma + DVH)
+// ============================================================================
+// Compara una distribucion "evaluada" (ej. modo rapido, menos eventos) contra
+// una de referencia, ambas salidas de phantom_sim.
+//
+// Uso:
+//   ./dose_compare ref.root[:objeto] eval.root[:objeto] [opciones]
+//
+// El objeto puede ser un TH1/TH2/TH3 (se usa su binning; los ejes con bins
+// variables se remuestrean al ancho del bin mas fino) o el TTree
+// "raw_data" (por defecto), que se binea con --bins/--range en dosis por
+// proton (Gy/primario) dentro de Phantom_phys.
+//
+// Opciones:
+//   --dd <%>          criterio de diferencia de dosis (default 3)
+//   --dta <mm>        distance-to-agreement (default 3)
+//   --local           gamma local, sin voxeles de dosis 0 (default: global)
+//   --cutoff <%>      umbral de dosis baja respecto a Dnorm (default 10)
+//   --search <mm>     radio maximo de busqueda (default 3 * DTA)
+//   --res <mm>        paso de busqueda (default DTA / 5)
+//   --threads <n>     hilos (default: todos los nucleos)
+//   --norm none|max   normalizacion de cada distribucion (default none)
+//   --bins nx ny nz   binning del TTree (default 400 1 1 = curva de Bragg)
+//   --range x0 x1 y0 y1 z0 z1   rango del TTree en cm
+//   --roi x0 x1 y0 y1 z0 z1     estructura para el DVH (default: todo)
+//   --dvh-bins <n>    bins del DVH (default 200)
+//   -o <archivo>      salida ROOT (default dose_compare.root)
+// ============================================================================
+
+#include "DoseComparison.hh"
+
+// Headers de ROOT
+#include "TFile.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ===== Binning para leer el TTree raw_data =====
+struct TreeBinning {
+  int n[3] = {400, 1, 1};
+  // Por defecto cubre el phantom: X en [-10, 30], Y/Z en [-10, 10] cm
+  double lo[3] = {-10.0, -10.0, -10.0};
+  double hi[3] = {30.0, 10.0, 10.0};
+};
+
+// ============================================================================
+// Eje del histograma -> eje regular de DoseGrid
+// ============================================================================
+// Bins variables (ej. cyl_dose con /phantom/score/cyl/radialEdges): se
+// remuestrea con el ancho del bin mas fino; la dosis es constante dentro de
+// cada bin original
+struct AxisMap {
+  int n = 1;
+  double x0 = 0, dx = 1;
+  std::vector<int> bin = {0}; // bin de ROOT de cada voxel de la malla
+};
+
+static AxisMap MapAxis(const TAxis *axis) {
+  AxisMap m;
+  int nBins = axis->GetNbins();
+  m.bin.clear();
+  if (!axis->IsVariableBinSize()) {
+    m.n = nBins;
+    m.x0 = axis->GetBinCenter(1);
+    m.dx = axis->GetBinWidth(1);
+    for (int b = 1; b <= nBins; b++)
+      m.bin.push_back(b);
+    return m;
+  }
+
+  double width = axis->GetBinWidth(1);
+  for (int b = 2; b <= nBins; b++)
+    width = std::min(width, axis->GetBinWidth(b));
+  double lo = axis->GetXmin(), hi = axis->GetXmax();
+  m.n = std::max(1, int(std::lround((hi - lo) / width)));
+  m.dx = (hi - lo) / m.n;
+  m.x0 = lo + 0.5 * m.dx;
+  for (int i = 0; i < m.n; i++)
+    m.bin.push_back(axis->FindFixBin(m.x0 + i * m.dx));
+  std::cout << "  eje " << axis->GetName() << ": " << nBins
+            << " bins variables -> " << m.n << " bins de " << m.dx << " cm"
+            << std::endl;
+  return m;
+}
+
+// ============================================================================
+// Lectura de un histograma TH1/TH2/TH3 a DoseGrid
+// ============================================================================
+static bool GridFromHistogram(TH1 *h, DoseGrid &grid) {
+  int dim = h->GetDimension();
+  AxisMap ax = MapAxis(h->GetXaxis());
+  AxisMap ay = dim > 1 ? MapAxis(h->GetYaxis()) : AxisMap();
+  AxisMap az = dim > 2 ? MapAxis(h->GetZaxis()) : AxisMap();
+
+  grid.nx = ax.n;
+  grid.ny = ay.n;
+  grid.nz = az.n;
+  grid.x0 = ax.x0;
+  grid.dx = ax.dx;
+  grid.y0 = ay.x0;
+  grid.dy = ay.dx;
+  grid.z0 = az.x0;
+  grid.dz = az.dx;
+
+  grid.dose.resize(grid.Size());
+  for (int k = 0; k < grid.nz; k++)
+    for (int j = 0; j < grid.ny; j++)
+      for (int i = 0; i < grid.nx; i++)
+        grid.dose[grid.Index(i, j, k)] =
+            h->GetBinContent(ax.bin[i], ay.bin[j], az.bin[k]);
+  return true;
+}
+
+// ============================================================================
+// Lectura del TTree raw_data a DoseGrid (Gy por proton primario)
+// ============================================================================
+static bool GridFromTree(TTree *tree, const TreeBinning &b, DoseGrid &grid) {
+  grid.nx = b.n[0];
+  grid.ny = b.n[1];
+  grid.nz = b.n[2];
+  double width[3];
+  for (int a = 0; a < 3; a++)
+    width[a] = (b.hi[a] - b.lo[a]) / b.n[a];
+  grid.dx = width[0];
+  grid.dy = width[1];
+  grid.dz = width[2];
+  grid.x0 = b.lo[0] + 0.5 * width[0];
+  grid.y0 = b.lo[1] + 0.5 * width[1];
+  grid.z0 = b.lo[2] + 0.5 * width[2];
+  grid.dose.assign(grid.Size(), 0.0);
+
+  // Solo leemos las ramas necesarias (el resto ni se descomprime)
+  int eventID = 0;
+  double x = 0, y = 0, z = 0, edep = 0, weight = 1;
+  char volumeName[32] = "";
+  tree->SetBranchStatus("*", 0);
+  const char *used[] = {"eventID", "x_pre", "y_pre", "z_pre", "edep",
+                        "volumeName"};
+  for (const char *name : used)
+    tree->SetBranchStatus(name, 1);
+  tree->SetBranchAddress("eventID", &eventID);
+  tree->SetBranchAddress("x_pre", &x);
+  tree->SetBranchAddress("y_pre", &y);
+  tree->SetBranchAddress("z_pre", &z);
+  tree->SetBranchAddress("edep", &edep);
+  tree->SetBranchAddress("volumeName", volumeName);
+  // Archivos con splitting/ruleta (/phantom/vr/): cada step lleva su peso
+  if (tree->GetBranch("weight")) {
+    tree->SetBranchStatus("weight", 1);
+    tree->SetBranchAddress("weight", &weight);
+  }
+
+  int maxEvent = -1;
+  Long64_t nEntries = tree->GetEntries();
+  for (Long64_t e = 0; e < nEntries; e++) {
+    tree->GetEntry(e);
+    maxEvent = std::max(maxEvent, eventID);
+    if (edep <= 0 || std::strcmp(volumeName, "Phantom_phys") != 0)
+      continue;
+    double p[3] = {x, y, z};
+    int idx[3];
+    bool inside = true;
+    for (int a = 0; a < 3 && inside; a++) {
+      idx[a] = int((p[a] - b.lo[a]) / width[a]);
+      inside = p[a] >= b.lo[a] && idx[a] >= 0 && idx[a] < b.n[a];
+    }
+    if (inside)
+      grid.dose[grid.Index(idx[0], idx[1], idx[2])] += weight * edep;
+  }
+  tree->ResetBranchAddresses();
+
+  // MeV -> Gy por primario (agua, rho = 1 g/cm3)
+  double mass_kg = width[0] * width[1] * width[2] * 1.0 / 1000.0;
+  double nEvents = maxEvent + 1;
+  double scale = nEvents > 0 ? 1.602176634e-13 / (mass_kg * nEvents) : 0;
+  for (double &d : grid.dose)
+    d *= scale;
+
+  std::cout << "  " << nEntries << " steps, " << maxEvent + 1 << " eventos"
+            << std::endl;
+  return true;
+}
+
+// ===== Abre "archivo.root[:objeto]" =====
+static bool LoadGrid(const std::string &spec, const TreeBinning &b,
+                     DoseGrid &grid) {
+  std::string fileName = spec;
+  std::string objName = "raw_data";
+  std::size_t colon = spec.rfind(':');
+  if (colon != std::string::npos && colon >= 5 &&
+      spec.compare(colon - 5, 5, ".root") == 0) {
+    fileName = spec.substr(0, colon);
+    objName = spec.substr(colon + 1);
+  }
+
+  std::cout << "Leyendo " << fileName << " : " << objName << std::endl;
+  TFile *f = TFile::Open(fileName.c_str());
+  if (!f || f->IsZombie()) {
+    std::cerr << "ERROR: no se puede abrir " << fileName << std::endl;
+    return false;
+  }
+
+  TObject *obj = f->Get(objName.c_str());
+  bool ok = false;
+  if (!obj) {
+    std::cerr << "ERROR: " << objName << " no existe en " << fileName
+              << std::endl;
+  } else if (obj->InheritsFrom(TH1::Class())) {
+    ok = GridFromHistogram(static_cast<TH1 *>(obj), grid);
+  } else if (obj->InheritsFrom(TTree::Class())) {
+    ok = GridFromTree(static_cast<TTree *>(obj), b, grid);
+  } else {
+    std::cerr << "ERROR: " << objName << " no es un histograma ni un TTree"
+              << std::endl;
+  }
+
+  f->Close();
+  delete f;
+  return ok;
+}
+
+// ===== DoseGrid -> histograma de ROOT con la misma geometria =====
+static TH1 *GridToHistogram(const DoseGrid &g, const char *name,
+                            const char *title) {
+  double xlo = g.x0 - 0.5 * g.dx, xhi = xlo + g.nx * g.dx;
+  double ylo = g.y0 - 0.5 * g.dy, yhi = ylo + g.ny * g.dy;
+  double zlo = g.z0 - 0.5 * g.dz, zhi = zlo + g.nz * g.dz;
+
+  TH1 *h;
+  if (g.nz > 1)
+    h = new TH3D(name, title, g.nx, xlo, xhi, g.ny, ylo, yhi, g.nz, zlo, zhi);
+  else if (g.ny > 1)
+    h = new TH2D(name, title, g.nx, xlo, xhi, g.ny, ylo, yhi);
+  else
+    h = new TH1D(name, title, g.nx, xlo, xhi);
+
+  int dim = h->GetDimension();
+  for (int k = 0; k < g.nz; k++)
+    for (int j = 0; j < g.ny; j++)
+      for (int i = 0; i < g.nx; i++)
+        h->SetBinContent(i + 1, dim > 1 ? j + 1 : 0, dim > 2 ? k + 1 : 0,
+                         g.dose[g.Index(i, j, k)]);
+  return h;
+}
+
+// ===== Mascara de voxeles dentro de la caja ROI (ejes degenerados: todos) ====
+static std::vector<char> BuildMask(const DoseGrid &g, const double roi[6]) {
+  std::vector<char> mask(g.Size(), 0);
+  for (int k = 0; k < g.nz; k++)
+    for (int j = 0; j < g.ny; j++)
+      for (int i = 0; i < g.nx; i++) {
+        double x = g.x0 + i * g.dx;
+        double y = g.y0 + j * g.dy;
+        double z = g.z0 + k * g.dz;
+        bool in = x >= roi[0] && x <= roi[1];
+        if (g.ny > 1)
+          in = in && y >= roi[2] && y <= roi[3];
+        if (g.nz > 1)
+          in = in && z >= roi[4] && z <= roi[5];
+        mask[g.Index(i, j, k)] = in;
+      }
+  return mask;
+}
+
+static void Normalize(DoseGrid &g) {
+  double m = g.Max();
+  if (m > 0)
+    for (double &d : g.dose)
+      d /= m;
+}
+
+static void PrintUsage() {
+  std::cout << "Uso: dose_compare ref.root[:obj] eval.root[:obj] [opciones]\n"
+            << "  --dd <%> --dta <mm> --local --cutoff <%> --search <mm>\n"
+            << "  --res <mm> --threads <n> --norm none|max\n"
+            << "  --bins nx ny nz --range x0 x1 y0 y1 z0 z1\n"
+            << "  --roi x0 x1 y0 y1 z0 z1 --dvh-bins <n> -o <archivo>"
+            << std::endl;
+}
+
+// ============================================================================
+// main
+// ============================================================================
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::string refSpec = argv[1];
+  std::string evalSpec = argv[2];
+  GammaOptions gopt;
+  TreeBinning binning;
+  std::string norm = "none";
+  std::string outName = "dose_compare.root";
+  int dvhBins = 200;
+  bool useROI = false;
+  double roi[6] = {0, 0, 0, 0, 0, 0};
+
+  // ===== Parsear opciones =====
+  for (int i = 3; i < argc; i++) {
+    std::string arg = argv[i];
+    auto need = [&](int n) {
+      if (i + n >= argc) {
+        std::cerr << "ERROR: " << arg << " necesita " << n << " valor(es)"
+                  << std::endl;
+        std::exit(1);
+      }
+    };
+    if (arg == "--dd") {
+      need(1);
+      gopt.doseCriterion = std::atof(argv[++i]) / 100.0;
+    } else if (arg == "--dta") {
+      need(1);
+      gopt.dtaCriterion = std::atof(argv[++i]) / 10.0; // mm -> cm
+    } else if (arg == "--local") {
+      gopt.local = true;
+    } else if (arg == "--cutoff") {
+      need(1);
+      gopt.lowDoseCutoff = std::atof(argv[++i]) / 100.0;
+    } else if (arg == "--search") {
+      need(1);
+      gopt.searchRadius = std::atof(argv[++i]) / 10.0;
+    } else if (arg == "--res") {
+      need(1);
+      gopt.resolution = std::atof(argv[++i]) / 10.0;
+    } else if (arg == "--threads") {
+      need(1);
+      gopt.nThreads = std::atoi(argv[++i]);
+    } else if (arg == "--norm") {
+      need(1);
+      norm = argv[++i];
+    } else if (arg == "--bins") {
+      need(3);
+      for (int a = 0; a < 3; a++)
+        binning.n[a] = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--range") {
+      need(6);
+      for (int a = 0; a < 3; a++) {
+        binning.lo[a] = std::atof(argv[++i]);
+        binning.hi[a] = std::atof(argv[++i]);
+      }
+    } else if (arg == "--roi") {
+      need(6);
+      for (int a = 0; a < 6; a++)
+        roi[a] = std::atof(argv[++i]);
+      useROI = true;
+    } else if (arg == "--dvh-bins") {
+      need(1);
+      dvhBins = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-o") {
+      need(1);
+      outName = argv[++i];
+    } else {
+      std::cerr << "ERROR: opcion desconocida " << arg << std::endl;
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  // ===== 1. Cargar distribuciones =====
+  DoseGrid ref, eval;
+  if (!LoadGrid(refSpec, binning, ref) || !LoadGrid(evalSpec, binning, eval))
+    return 1;
+  if (ref.Dimension() != eval.Dimension()) {
+    std::cerr << "ERROR: dimensiones distintas (" << ref.Dimension() << "D vs "
+              << eval.Dimension() << "D)" << std::endl;
+    return 1;
+  }
+  if (norm == "max") {
+    Normalize(ref);
+    Normalize(eval);
+  }
+
+  // ===== 2. Indice gamma =====
+  auto t0 = std::chrono::steady_clock::now();
+  GammaResult gamma = ComputeGamma(ref, eval, gopt);
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count();
+
+  // ===== 3. DVH (misma escala para ambas) =====
+  std::vector<char> maskRef, maskEval;
+  if (useROI) {
+    maskRef = BuildMask(ref, roi);
+    maskEval = BuildMask(eval, roi);
+  }
+  double dvhMax = 1.05 * std::max(ref.Max(), eval.Max());
+  if (dvhMax <= 0) {
+    std::cerr << "ERROR: ambas distribuciones tienen dosis nula" << std::endl;
+    return 1;
+  }
+  DVH dvhRef = ComputeDVH(ref, dvhBins, dvhMax, useROI ? &maskRef : nullptr);
+  DVH dvhEval = ComputeDVH(eval, dvhBins, dvhMax, useROI ? &maskEval : nullptr);
+
+  // ===== 4. Resumen en pantalla =====
+  std::cout << "========================================" << std::endl;
+  std::cout << " GAMMA " << (gopt.local ? "LOCAL" : "GLOBAL") << " "
+            << gopt.doseCriterion * 100 << "% / " << gopt.dtaCriterion * 10
+            << " mm  (cutoff " << gopt.lowDoseCutoff * 100 << "%)"
+            << std::endl;
+  std::cout << " Malla: " << ref.Dimension() << "D, " << ref.Size()
+            << " voxeles" << std::endl;
+  std::cout << " Puntos evaluados: " << gamma.nEvaluated << std::endl;
+  std::printf(" Pass rate: %.2f %%\n", 100.0 * gamma.passRate);
+  std::printf(" Gamma medio: %.3f  maximo: %.3f\n", gamma.meanGamma,
+              gamma.maxGamma);
+  std::printf(" Tiempo: %.2f s\n", seconds);
+  std::cout << "----------------------------------------" << std::endl;
+  std::cout << " DVH          ref          eval" << std::endl;
+  const double fractions[] = {0.98, 0.95, 0.50, 0.02};
+  const char *labels[] = {"D98", "D95", "D50", "D2"};
+  for (int i = 0; i < 4; i++)
+    std::printf(" %-6s %12.4e %12.4e\n", labels[i],
+                dvhRef.DoseAtVolume(fractions[i]),
+                dvhEval.DoseAtVolume(fractions[i]));
+  std::cout << "========================================" << std::endl;
+
+  // ===== 5. Guardar en ROOT =====
+  // Los histogramas quedan asociados al archivo y se borran al cerrarlo
+  TFile out(outName.c_str(), "RECREATE");
+  GridToHistogram(ref, "dose_ref", "Dosis referencia")->Write();
+  GridToHistogram(eval, "dose_eval", "Dosis evaluada")->Write();
+  GridToHistogram(gamma.gamma, "gamma_map", "Indice gamma (-1 = no evaluado)")
+      ->Write();
+
+  TH1D *hGamma =
+      new TH1D("gamma_hist", "Distribucion gamma;#gamma;Voxeles", 300, 0, 3);
+  for (double g : gamma.gamma.dose)
+    if (g >= 0)
+      hGamma->Fill(g);
+  hGamma->Write();
+
+  TH1D *hRef =
+      new TH1D("dvh_ref", "DVH acumulado referencia;Dosis;Fraccion de volumen",
+               dvhBins, 0, dvhMax);
+  TH1D *hEval =
+      new TH1D("dvh_eval", "DVH acumulado evaluado;Dosis;Fraccion de volumen",
+               dvhBins, 0, dvhMax);
+  for (int b = 0; b < dvhBins; b++) {
+    hRef->SetBinContent(b + 1, dvhRef.volume[b]);
+    hEval->SetBinContent(b + 1, dvhEval.volume[b]);
+  }
+  hRef->Write();
+  hEval->Write();
+  out.Close();
+
+  std::cout << "Resultados guardados en " << outName << std::endl;
+  return 0;
+}